@@ -0,0 +1,76 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGINMODULEINTERFACE_V3_H
+#define LOGINMODULEINTERFACE_V3_H
+
+#include "login_module_interface_v2.h"
+
+#include <QVariantMap>
+
+namespace dss {
+namespace module_v3 {
+
+const QString LOGIN_API_VERSION = "3.0.0";
+
+using AuthResult = dss::module::AuthResult;
+using AppType = dss::module::AppType;
+using AuthType = dss::module::AuthType;
+using AuthState = dss::module::AuthState;
+using DefaultAuthLevel = dss::module::DefaultAuthLevel;
+using AppDataPtr = dss::module::AppDataPtr;
+using MessageCallbackFunc = dss::module::MessageCallbackFunc;
+using AuthCallbackData = dss::module_v2::AuthCallbackData;
+using AuthCallbackFun = dss::module_v2::AuthCallbackFun;
+using AuthObjectType = dss::module_v2::AuthObjectType;
+
+/**
+ * @brief 结构化消息回调函数
+ * @param const QVariantMap & 发送给登录器的数据
+ * @param void * 登录器回传指针
+ *
+ * @return 登录器返回的数据
+ * @since 3.0.0
+ *
+ * 消息的字段和 2.0.0 中 json 字符串的字段相同，例如 {"CmdType": "GetProperties", "Data": ["AppType"]}，
+ * 返回 {"Code": 0, "Message": "Success", "Data": {...}}，数据直接传递，不需要序列化和解析。
+ */
+using StructuredMessageCallbackFunc = QVariantMap (*)(const QVariantMap &, void *);
+
+/**
+ * @brief 3.0.0 版本的登录插件接口
+ *
+ * 在 2.0.0 的基础上增加结构化消息接口，登录器和插件之间直接传递 QVariantMap。
+ * 登录器只通过结构化接口给 3.0.0 的插件发送消息，2.0.0 的 json 字符串接口保留给旧插件使用。
+ */
+class LoginModuleInterfaceV3 : public dss::module_v2::LoginModuleInterfaceV2
+{
+public:
+    using dss::module_v2::LoginModuleInterfaceV2::message;
+
+    /**
+     * @brief 设置结构化消息回调函数，和 setMessageCallback 设置的回调函数功能相同
+     *
+     * @since 3.0.0
+     */
+    virtual void setStructuredMessageCallback(StructuredMessageCallbackFunc) {}
+
+    /**
+     * @brief 登录器通过此函数发送消息给插件，获取插件的信息或者同步登录器等。
+     *
+     * 消息的字段和 2.0.0 中 json 字符串的字段相同，返回值为空时视为插件不处理此消息。
+     *
+     * @since 3.0.0
+     */
+    virtual QVariantMap message(const QVariantMap &) { return QVariantMap(); }
+
+    // Warning: 不要增加虚函数，即使在最后面（如果派生类也有虚函数，那么虚表寻址也会错误）
+};
+
+} // namespace module_v3
+} // namespace dss
+
+Q_DECLARE_INTERFACE(dss::module_v3::LoginModuleInterfaceV3, "com.deepin.dde.shell.Modules_v3.Login")
+
+#endif // LOGINMODULEINTERFACE_V3_H
@@ -12,6 +12,7 @@
 #include "lighterbackground.h"
 #include "dconfig_helper.h"
 #include "constants.h"
+#include "image_cache.h"
 
 LighterBackground::LighterBackground(QWidget *content, QWidget *parent)
     : QWidget(parent)
@@ -81,15 +82,17 @@ void LighterBackground::paintEvent(QPaintEvent *event)
     if (!QFile("/usr/share/backgrounds/default_background.jpg").exists() || m_useSolidBackground) {
         painter.fillRect(trueRect, QColor(DDESESSIONCC::SOLID_BACKGROUND_COLOR));
     } else {
-        // cache the pixmap
-        static QPixmap background = QPixmap("/usr/share/backgrounds/default_background.jpg").scaled(width(), height(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
-
-        // 缓存图片大小和当前屏幕大小不一致时，需要调整尺寸
-        if (background.size() != this->size()) {
-            background.scaled(width(), height(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        // 按屏幕尺寸缓存缩放后的壁纸，多个屏幕尺寸不同时互不覆盖
+        const QString backgroundPath = "/usr/share/backgrounds/default_background.jpg";
+        const QString cacheKey = ImageCache::cacheKey(backgroundPath, trueRect.size(), devicePixelRatioF(), "lighter-background");
+        QPixmap background;
+        if (!ImageCache::instance()->find(cacheKey, background)) {
+            background = QPixmap(backgroundPath).scaled(trueRect.size(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+            background.setDevicePixelRatio(devicePixelRatioF());
+            ImageCache::instance()->insert(cacheKey, background);
         }
 
-        painter.drawPixmap(trueRect, background, QRect(trueRect.topLeft(), trueRect.size() * background.devicePixelRatioF()));
+        painter.drawPixmap(rect(), background);
     }
 }
 
@@ -699,6 +699,20 @@ void LockWorker::createAuthentication(const QString &account)
         return;
     }
 
+    std::shared_ptr<User> user_ptr = m_model->findUserByName(account);
+    if (user_ptr) {
+        // 轻量用户的数据异步返回，返回后再创建认证，避免按默认的账户信息判断无密码登录
+        user_ptr->materialize();
+        if (user_ptr->isLoading()) {
+            auto connection = std::make_shared<QMetaObject::Connection>();
+            *connection = connect(user_ptr.get(), &User::dataLoaded, this, [this, account, connection] {
+                disconnect(*connection);
+                createAuthentication(account);
+            });
+            return;
+        }
+    }
+
     // 如果验证会话已经存在，销毁后重新开启验证
     if (m_authFramework->authSessionExist(account) || m_authFramework->IsUsingPamAuth()) {
         endAuthentication(account, AT_All);
@@ -706,7 +720,6 @@ void LockWorker::createAuthentication(const QString &account)
     }
 
     // 同步密码过期的信息
-    std::shared_ptr<User> user_ptr = m_model->findUserByName(account);
     if (user_ptr) {
         user_ptr->updatePasswordExpiredInfo();
 
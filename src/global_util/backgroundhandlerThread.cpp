@@ -5,11 +5,15 @@
 
 #include "backgroundhandlerThread.h"
 #include "public_func.h"
+#include "wallpaper_disk_cache.h"
 
 #include <QImageReader>
 
 BackgroundHandlerThread::BackgroundHandlerThread(QObject *parent)
     : QThread(parent)
+    , m_devicePixelRatioF(1.0)
+    , m_useDiskCache(false)
+    , m_handled(false)
 {
 
 }
@@ -26,25 +30,72 @@ void BackgroundHandlerThread::run()
     handle();
 }
 
-QPixmap BackgroundHandlerThread::handleBackground(const QString &path, const QSize &size, const qreal &devicePixelRatioF)
+QImage BackgroundHandlerThread::handleBackground(const QString &path, const QSize &size, const qreal &devicePixelRatioF)
 {
-    QPixmap pixmap;
-    pixmap = loadPixmap(path);
+    QImageReader reader(path);
+    reader.setDecideFormatFromContent(true);
+    if (!reader.canRead() || size.isEmpty()) {
+        return QImage();
+    }
 
-    pixmap = pixmap.scaled(size, Qt::KeepAspectRatioByExpanding, Qt::FastTransformation);
-    pixmap = pixmap.copy(QRect((pixmap.width() - size.width()) / 2,
-                               (pixmap.height() - size.height()) / 2,
-                               size.width(),
-                               size.height()));
+    // 解码时直接缩放到覆盖目标区域的尺寸，jpeg等格式可以少解码很多像素
+    const QSize imageSize = reader.size();
+    if (imageSize.isValid() && imageSize != size) {
+        reader.setScaledSize(imageSize.scaled(size, Qt::KeepAspectRatioByExpanding));
+    }
+
+    QImage image = reader.read();
+    if (image.isNull()) {
+        return image;
+    }
+
+    if (image.size() != size) {
+        image = image.scaled(size, Qt::KeepAspectRatioByExpanding, Qt::FastTransformation);
+        image = image.copy(QRect((image.width() - size.width()) / 2,
+                                 (image.height() - size.height()) / 2,
+                                 size.width(),
+                                 size.height()));
+    }
 
     // draw pix to widget, so pix need set pixel ratio from qwidget devicepixelratioF
-    pixmap.setDevicePixelRatio(devicePixelRatioF);
+    image.setDevicePixelRatio(devicePixelRatioF);
 
-    return pixmap;
+    return image;
 }
 
 void BackgroundHandlerThread::handle()
 {
-    auto pixmap = handleBackground(m_path, m_targetSize, m_devicePixelRatioF);
-    emit backgroundHandled(pixmap);
+    QImage image;
+    if (m_useDiskCache) {
+        image = WallpaperDiskCache::load(m_path, m_targetSize, m_devicePixelRatioF);
+    }
+
+    if (image.isNull()) {
+        image = handleBackground(m_path, m_targetSize, m_devicePixelRatioF);
+        if (m_useDiskCache && !image.isNull() && !isInterruptionRequested()) {
+            WallpaperDiskCache::save(m_path, m_targetSize, m_devicePixelRatioF, image);
+        }
+    }
+
+    if (isInterruptionRequested()) {
+        return;
+    }
+
+    {
+        QMutexLocker locker(&m_resultMutex);
+        m_result = image;
+        m_handled = true;
+    }
+    emit backgroundHandled(image);
+}
+
+bool BackgroundHandlerThread::result(QImage &image) const
+{
+    QMutexLocker locker(&m_resultMutex);
+    if (!m_handled) {
+        return false;
+    }
+
+    image = m_result;
+    return true;
 }
@@ -7,8 +7,15 @@
 
 #include <QSize>
 #include <QThread>
-#include <QPixmap>
-
+#include <QImage>
+#include <QMutex>
+
+/**
+ * @brief 在线程中解码并缩放壁纸
+ *
+ * 线程中只能使用QImage，结果通过信号交给主线程再转换为QPixmap。
+ * 调用requestInterruption()后不再发出结果，用于新的壁纸请求取消旧的请求。
+ */
 class BackgroundHandlerThread : public QThread
 {
     Q_OBJECT
@@ -16,23 +23,31 @@ public:
     explicit BackgroundHandlerThread(QObject *parent = nullptr);
 
     void setBackgroundInfo(const QString &path, const QSize &size, const qreal &devicePixelRatioF);
+    // 使用磁盘缓存保存缩放后的图片，没有壁纸服务时开启
+    void setUseDiskCache(bool use) { m_useDiskCache = use; }
 
     // 直接调用handle则不会通过线程处理图片
     void handle();
 
+    static QImage handleBackground(const QString &path, const QSize &size, const qreal &devicePixelRatioF);
+
+    // 结果发出之后才连接信号的对象通过这里获取结果
+    bool result(QImage &image) const;
+
 signals:
-    void backgroundHandled(const QPixmap &pixmap);
+    void backgroundHandled(const QImage &image);
 
 protected:
     void run() override;
 
-private:
-    static QPixmap handleBackground(const QString &path, const QSize &size, const qreal &devicePixelRatioF);
-
 private:
     QString m_path;
     QSize m_targetSize;
     qreal m_devicePixelRatioF;
+    bool m_useDiskCache;
+    mutable QMutex m_resultMutex;
+    bool m_handled;
+    QImage m_result;
 };
 
 #endif //DDE_SESSION_SHELL_BACKGROUNDHANDLERTHREAD_H
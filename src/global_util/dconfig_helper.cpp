@@ -41,12 +41,27 @@ DConfig *DConfigHelper::initializeDConfig(const QString &appId,
     m_dConfigs[packageDConfigPath(appId, name, subpath)] = dConfig;
     m_bindInfos[dConfig] = {};
 
+    {
+        // 键列表只获取一次，值在第一次读取时缓存
+        QMutexLocker snapshotLocker(&m_snapshotMutex);
+        Snapshot &snapshot = m_snapshots[dConfig];
+        for (const QString &key : dConfig->keyList()) {
+            snapshot.keys.insert(key);
+        }
+    }
+
     dConfig->moveToThread(qApp->thread());
     dConfig->setParent(this);
 
     // 即时响应数据变化
     connect(dConfig, &DConfig::valueChanged, this, [this, dConfig](const QString &key) {
         const QVariant &value = dConfig->value(key);
+        {
+            QMutexLocker snapshotLocker(&m_snapshotMutex);
+            Snapshot &snapshot = m_snapshots[dConfig];
+            snapshot.keys.insert(key);
+            snapshot.values.insert(key, value);
+        }
         auto it = m_bindInfos.find(dConfig);
         if (it == m_bindInfos.end())
             return;
@@ -170,10 +185,17 @@ QVariant DConfigHelper::getConfig(const QString &appId,
         return defaultValue;
     }
 
-    if (!dConfig->keyList().contains(key))
+    QMutexLocker snapshotLocker(&m_snapshotMutex);
+    Snapshot &snapshot = m_snapshots[dConfig];
+    auto it = snapshot.values.constFind(key);
+    if (it != snapshot.values.constEnd())
+        return it.value();
+
+    if (!snapshot.keys.contains(key))
         return defaultValue;
 
     const QVariant &value = dConfig->value(key);
+    snapshot.values.insert(key, value);
     return value;
 }
 
@@ -189,9 +211,15 @@ void DConfigHelper::setConfig(const QString &appId,
         return;
     }
 
-    if (!dConfig->keyList().contains(key)) {
-        qCWarning(DDE_SHELL) << "DConfig does not contain key: " << key;
-        return;
+    {
+        QMutexLocker snapshotLocker(&m_snapshotMutex);
+        Snapshot &snapshot = m_snapshots[dConfig];
+        if (!snapshot.keys.contains(key)) {
+            qCWarning(DDE_SHELL) << "DConfig does not contain key: " << key;
+            return;
+        }
+        // 写入后立即可以读到新值，valueChanged 时再以 DConfig 中的值为准
+        snapshot.values.insert(key, value);
     }
 
     dConfig->setValue(key, value);
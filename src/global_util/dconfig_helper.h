@@ -6,8 +6,10 @@
 
 #include <DConfig>
 
+#include <QHash>
 #include <QMap>
 #include <QMutex>
+#include <QSet>
 #include <QObject>
 
 using OnPropertyChangedCallback = void (*)(const QString &, const QVariant &, QObject *);
@@ -20,6 +22,12 @@ using OnPropertyChangedCallback = void (*)(const QString &, const QVariant &, QO
  */
 using OnPropertiesChanged = void (*)(const QString &key, const QVariant &value);
 
+/**
+ * @brief DConfig 配置的读写和变化通知
+ *
+ * 每个配置文件的键列表和读取过的值保存在内存中，DConfig::valueChanged 时更新，
+ * getConfig 只需要查找哈希表，不需要每次获取键列表和读取配置。
+ */
 class DConfigHelper : public QObject
 {
     Q_OBJECT
@@ -65,9 +73,16 @@ private:
                                const QString &name,
                                const QString &subpath) const;
 
+    struct Snapshot {
+        QSet<QString> keys;
+        QHash<QString, QVariant> values;
+    };
+
 private:
     QMutex m_mutex;
     QMap<QString, Dtk::Core::DConfig *> m_dConfigs;
     QMap<Dtk::Core::DConfig *, QMap<QObject *, QStringList>> m_bindInfos;
     QMap<QObject *, OnPropertyChangedCallback> m_objCallbackMap;
+    QMutex m_snapshotMutex;
+    QHash<Dtk::Core::DConfig *, Snapshot> m_snapshots;
 };
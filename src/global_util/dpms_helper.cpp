@@ -0,0 +1,125 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "dpms_helper.h"
+#include "constants.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QGuiApplication>
+#include <QProcess>
+#ifndef ENABLE_DSS_SNIPE
+#include <QX11Info>
+#endif
+
+#include <X11/Xlib.h>
+#include <X11/extensions/dpms.h>
+
+// 两次唤醒之间的最小间隔，连续的指纹重试只会真正唤醒一次
+static const qint64 WAKE_UP_INTERVAL_MS = 500;
+
+Q_GLOBAL_STATIC(DpmsHelper, dpmsHelper)
+
+DpmsHelper::DpmsHelper(QObject *parent)
+    : QObject(parent)
+    , m_isWayland(QGuiApplication::platformName().startsWith("wayland", Qt::CaseInsensitive))
+    , m_lastWakeUpTime(0)
+    , m_wakeUpPending(false)
+    , m_sessionActive(true)
+{
+    moveToThread(qApp->thread());
+}
+
+DpmsHelper *DpmsHelper::instance()
+{
+    return dpmsHelper;
+}
+
+/**
+ * @brief 唤醒屏幕，线程安全
+ */
+void DpmsHelper::wakeUp()
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (now - m_lastWakeUpTime < WAKE_UP_INTERVAL_MS) {
+        return;
+    }
+
+    // 已经有一次唤醒在排队，不再重复投递
+    if (m_wakeUpPending.exchange(true)) {
+        return;
+    }
+
+    QMetaObject::invokeMethod(this, "doWakeUp", Qt::QueuedConnection);
+}
+
+/**
+ * @brief 更新 login1 session 的激活状态，由 login1 的 ActiveChanged 信号驱动
+ */
+void DpmsHelper::setSessionActive(bool active)
+{
+    m_sessionActive = active;
+}
+
+void DpmsHelper::doWakeUp()
+{
+    m_wakeUpPending = false;
+    m_lastWakeUpTime = QDateTime::currentMSecsSinceEpoch();
+
+    if (m_isWayland) {
+        wakeUpByWayland();
+    } else {
+        wakeUpByX11();
+    }
+}
+
+bool DpmsHelper::wakeUpByX11()
+{
+#ifndef ENABLE_DSS_SNIPE
+    Display *display = QX11Info::display();
+#else
+    Display *display = nullptr;
+    if (auto x11Application = qGuiApp->nativeInterface<QNativeInterface::QX11Application>())
+        display = x11Application->display();
+#endif
+    if (!display) {
+        qCWarning(DDE_SHELL) << "Display is null, can not wake up screen";
+        return false;
+    }
+
+    int eventBase = 0;
+    int errorBase = 0;
+    if (!DPMSQueryExtension(display, &eventBase, &errorBase) || !DPMSCapable(display)) {
+        qCWarning(DDE_SHELL) << "DPMS extension is not available";
+        return false;
+    }
+
+    CARD16 powerLevel = DPMSModeOn;
+    BOOL enabled = False;
+    DPMSInfo(display, &powerLevel, &enabled);
+    // 屏幕本来就是亮的，不需要再次设置
+    if (enabled && powerLevel == DPMSModeOn) {
+        return true;
+    }
+
+    qCInfo(DDE_SHELL) << "Wake up screen by DPMS, power level:" << powerLevel << ", enabled:" << enabled;
+    if (!enabled) {
+        DPMSEnable(display);
+    }
+    DPMSForceLevel(display, DPMSModeOn);
+    XFlush(display);
+    return true;
+}
+
+void DpmsHelper::wakeUpByWayland()
+{
+    // session 未激活的时候使用 dde_wldpms 无效，且 dde_wldpms 无法收到 modeChanged 信号，会一直处于等待状态不退出
+    if (!m_sessionActive) {
+        qCInfo(DDE_SHELL) << "Current session is not active, skip waking up screen by dde_wldpms";
+        return;
+    }
+
+    qCInfo(DDE_SHELL) << "Wake up screen by dde_wldpms";
+    QProcess::startDetached("dde_wldpms", {"-s", "on"});
+}
@@ -0,0 +1,45 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DPMS_HELPER_H
+#define DPMS_HELPER_H
+
+#include <QObject>
+
+#include <atomic>
+
+/**
+ * @brief 进程内唤醒屏幕，替代 system("xset dpms force on")
+ *
+ * X11 下直接通过 DPMS 扩展点亮屏幕，wayland 下使用 dde_wldpms。
+ * wakeUp() 可以在任意线程调用，实际操作在主线程执行，并对短时间内的重复调用做限流。
+ * 当前 session 未激活时 dde_wldpms 收不到 modeChanged 信号，会一直等待不退出，此时跳过 wayland 下的唤醒。
+ */
+class DpmsHelper : public QObject
+{
+    Q_OBJECT
+public:
+    explicit DpmsHelper(QObject *parent = nullptr);
+    static DpmsHelper *instance();
+
+    void wakeUp();
+    void setSessionActive(bool active);
+
+private Q_SLOTS:
+    void doWakeUp();
+
+private:
+    Q_DISABLE_COPY(DpmsHelper)
+
+    bool wakeUpByX11();
+    void wakeUpByWayland();
+
+private:
+    bool m_isWayland;
+    std::atomic<qint64> m_lastWakeUpTime;
+    std::atomic_bool m_wakeUpPending;
+    std::atomic_bool m_sessionActive;
+};
+
+#endif // DPMS_HELPER_H
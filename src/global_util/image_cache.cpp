@@ -0,0 +1,130 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "image_cache.h"
+#include "constants.h"
+#include "dconfig_helper.h"
+
+#include <QApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QFileInfo>
+
+static const QString IMAGE_CACHE_SIZE = "imageCacheSize";
+static const int DEFAULT_IMAGE_CACHE_SIZE_MB = 64;
+
+Q_GLOBAL_STATIC(ImageCache, imageCache)
+
+ImageCache::ImageCache(QObject *parent)
+    : QObject(parent)
+    , m_hitCount(0)
+    , m_missCount(0)
+{
+    moveToThread(qApp->thread());
+
+    const int sizeMB = DConfigHelper::instance()->getConfig(IMAGE_CACHE_SIZE, DEFAULT_IMAGE_CACHE_SIZE_MB).toInt();
+    setByteBudget(static_cast<qint64>(sizeMB) * 1024 * 1024);
+    DConfigHelper::instance()->bind(this, IMAGE_CACHE_SIZE, &ImageCache::onDConfigPropertyChanged);
+}
+
+ImageCache *ImageCache::instance()
+{
+    return imageCache;
+}
+
+/**
+ * @brief 生成缓存键值
+ *
+ * @param path 源文件路径
+ * @param size 目标尺寸（物理像素）
+ * @param devicePixelRatio 缩放比例
+ * @param tag 用途，同一张图片不同的处理方式（模糊、灰度、圆角等）需要区分
+ */
+QString ImageCache::cacheKey(const QString &path, const QSize &size, qreal devicePixelRatio, const QString &tag)
+{
+    const QFileInfo info(path);
+    return QString("%1|%2|%3x%4|%5|%6").arg(path)
+                                      .arg(info.lastModified().toMSecsSinceEpoch())
+                                      .arg(size.width())
+                                      .arg(size.height())
+                                      .arg(devicePixelRatio)
+                                      .arg(tag);
+}
+
+bool ImageCache::find(const QString &key, QPixmap &pixmap)
+{
+    QPixmap *cached = m_cache.object(key);
+    if (!cached) {
+        ++m_missCount;
+        return false;
+    }
+
+    ++m_hitCount;
+    pixmap = *cached;
+    return true;
+}
+
+void ImageCache::insert(const QString &key, const QPixmap &pixmap)
+{
+    if (pixmap.isNull()) {
+        return;
+    }
+
+    const qint64 bytes = static_cast<qint64>(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+    const int cost = static_cast<int>(qMax<qint64>(1, bytes / 1024));
+    // 超过上限的图片QCache不会保存，调用方自己持有即可
+    if (!m_cache.insert(key, new QPixmap(pixmap), cost)) {
+        qCDebug(DDE_SHELL) << "Image is too large to cache, key:" << key << ", bytes:" << bytes;
+    }
+}
+
+void ImageCache::remove(const QString &key)
+{
+    m_cache.remove(key);
+}
+
+/**
+ * @brief 移除某个源文件的所有缓存，用于文件内容变化但修改时间不变的场景
+ */
+void ImageCache::removeByPath(const QString &path)
+{
+    const QString prefix = path + "|";
+    const auto keys = m_cache.keys();
+    for (const QString &key : keys) {
+        if (key.startsWith(prefix)) {
+            m_cache.remove(key);
+        }
+    }
+}
+
+void ImageCache::clear()
+{
+    m_cache.clear();
+}
+
+void ImageCache::setByteBudget(qint64 bytes)
+{
+    m_cache.setMaxCost(static_cast<int>(qMax<qint64>(0, bytes / 1024)));
+}
+
+qint64 ImageCache::byteBudget() const
+{
+    return static_cast<qint64>(m_cache.maxCost()) * 1024;
+}
+
+qint64 ImageCache::usedBytes() const
+{
+    return static_cast<qint64>(m_cache.totalCost()) * 1024;
+}
+
+void ImageCache::onDConfigPropertyChanged(const QString &key, const QVariant &value, QObject *objPtr)
+{
+    auto obj = qobject_cast<ImageCache *>(objPtr);
+    if (!obj || key != IMAGE_CACHE_SIZE)
+        return;
+
+    qCInfo(DDE_SHELL) << "Image cache size changed:" << value.toInt() << "MB"
+                      << ", hit:" << obj->hitCount() << ", miss:" << obj->missCount();
+    obj->setByteBudget(static_cast<qint64>(value.toInt()) * 1024 * 1024);
+}
@@ -0,0 +1,52 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef IMAGE_CACHE_H
+#define IMAGE_CACHE_H
+
+#include <QCache>
+#include <QObject>
+#include <QPixmap>
+
+/**
+ * @brief 进程内共享的图片缓存
+ *
+ * 缓存解码、缩放后的图片，键值由源文件路径、修改时间、目标尺寸、缩放比例和用途组成，
+ * 壁纸更换或者文件被修改后自然失效。按字节数做LRU淘汰，上限由配置 imageCacheSize（MB）控制。
+ * 只能在主线程中使用。
+ */
+class ImageCache : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ImageCache(QObject *parent = nullptr);
+    static ImageCache *instance();
+
+    static QString cacheKey(const QString &path, const QSize &size, qreal devicePixelRatio, const QString &tag = QString());
+
+    bool find(const QString &key, QPixmap &pixmap);
+    void insert(const QString &key, const QPixmap &pixmap);
+    void remove(const QString &key);
+    void removeByPath(const QString &path);
+    void clear();
+
+    void setByteBudget(qint64 bytes);
+    qint64 byteBudget() const;
+    qint64 usedBytes() const;
+    quint64 hitCount() const { return m_hitCount; }
+    quint64 missCount() const { return m_missCount; }
+
+private:
+    Q_DISABLE_COPY(ImageCache)
+
+    static void onDConfigPropertyChanged(const QString &key, const QVariant &value, QObject *objPtr);
+
+private:
+    // 代价以KB为单位，避免大图超出int范围
+    QCache<QString, QPixmap> m_cache;
+    quint64 m_hitCount;
+    quint64 m_missCount;
+};
+
+#endif // IMAGE_CACHE_H
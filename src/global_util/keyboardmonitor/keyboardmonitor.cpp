@@ -11,7 +11,7 @@
 DGUI_USE_NAMESPACE
 
 KeyboardMonitor::KeyboardMonitor()
-    : QThread()
+    : QObject()
     , m_keyBoardPlatform(nullptr)
 {
     if (DGuiApplicationHelper::isXWindowPlatform()) {
@@ -26,9 +26,8 @@ KeyboardMonitor::KeyboardMonitor()
         connect(m_keyBoardPlatform, &KeyBoardPlatform::capsLockStatusChanged, this, &KeyboardMonitor::capsLockStatusChanged);
         connect(m_keyBoardPlatform, &KeyBoardPlatform::numLockStatusChanged, this, &KeyboardMonitor::numLockStatusChanged);
         connect(m_keyBoardPlatform, &KeyBoardPlatform::initialized, this, &KeyboardMonitor::initialized);
+        m_keyBoardPlatform->run();
     }
-
-    start(QThread::LowestPriority);
 }
 
 KeyboardMonitor *KeyboardMonitor::instance()
@@ -66,14 +65,6 @@ bool KeyboardMonitor::setNumLockStatus(const bool &on)
     return m_keyBoardPlatform->setNumLockStatus(on);
 }
 
-void KeyboardMonitor::run()
-{
-    if (!m_keyBoardPlatform)
-        return;
-
-    m_keyBoardPlatform->run();
-}
-
 void KeyboardMonitor::ungrabKeyboard()
 {
     if (!m_keyBoardPlatform)
@@ -5,7 +5,7 @@
 #ifndef KEYBOARDMONITOR_H
 #define KEYBOARDMONITOR_H
 
-#include <QThread>
+#include <QObject>
 #include "keyboardplantform_x11.h"
 #ifdef USE_DEEPIN_WAYLAND
 #include "keyboardplantform_wayland.h"
@@ -13,7 +13,12 @@
 
 #define DPMS_STATE_FILE "/tmp/dpms-state" //black screen state;bug:222049
 
-class KeyboardMonitor : public QThread
+/**
+ * @brief 键盘状态监听
+ *
+ * 各平台的实现都在主线程的事件循环中接收事件，不需要单独的线程。
+ */
+class KeyboardMonitor : public QObject
 {
     Q_OBJECT
 public:
@@ -29,9 +34,6 @@ signals:
     void numLockStatusChanged(bool on);
     void initialized();
 
-protected:
-    void run() Q_DECL_OVERRIDE;
-
 private:
     KeyboardMonitor();
     KeyBoardPlatform* m_keyBoardPlatform;
@@ -22,7 +22,123 @@
 #include <QDBusConnection>
 #include <QDBusPendingReply>
 #include <QApplication>
-#include <QProcess>
+#include <QElapsedTimer>
+
+#include <cstring>
+#include <memory>
+
+// X11 的头文件定义了很多宏，需要放在最后
+#include <X11/XF86keysym.h>
+#include <X11/XKBlib.h>
+#include <X11/Xlib.h>
+#include <X11/extensions/XTest.h>
+
+namespace {
+
+using XkbDescDeleter = void (*)(XkbDescPtr);
+using XkbDescHolder = std::unique_ptr<XkbDescRec, XkbDescDeleter>;
+
+void freeXkbDesc(XkbDescPtr xkb)
+{
+    XkbFreeKeyboard(xkb, 0, True);
+}
+
+XkbDescHolder getKeyMap(Display *display)
+{
+    const unsigned int mapMask = XkbKeyTypesMask | XkbKeySymsMask | XkbKeyActionsMask | XkbExplicitComponentsMask;
+    return XkbDescHolder(XkbGetMap(display, mapMask, XkbUseCoreKbd), freeXkbDesc);
+}
+
+/**
+ * @brief 在 Xwayland 中断开 X 客户端的键盘、鼠标抓取
+ *
+ * 和 grab:break_actions 选项的做法相同：临时给一个没有使用的键码绑定 XF86Ungrab 私有动作，
+ * 通过 XTest 按下、释放这个键，再恢复这个键码原来的映射，不需要修改 XKB 选项，也不需要启动其它进程。
+ */
+bool breakXGrabs()
+{
+    std::unique_ptr<Display, int (*)(Display *)> display(XOpenDisplay(nullptr), XCloseDisplay);
+    if (!display) {
+        qCWarning(DDE_SHELL) << "Failed to open display, can not break grabs";
+        return false;
+    }
+
+    int opcode = 0;
+    int event = 0;
+    int error = 0;
+    int major = XkbMajorVersion;
+    int minor = XkbMinorVersion;
+    if (!XkbQueryExtension(display.get(), &opcode, &event, &error, &major, &minor)) {
+        qCWarning(DDE_SHELL) << "XKB extension is not available, can not break grabs";
+        return false;
+    }
+
+    XkbDescHolder xkb = getKeyMap(display.get());
+    XkbDescHolder origin = getKeyMap(display.get());
+    if (!xkb || !origin) {
+        qCWarning(DDE_SHELL) << "Failed to get keyboard map, can not break grabs";
+        return false;
+    }
+
+    int keycode = 0;
+    for (int code = xkb->max_key_code; code >= xkb->min_key_code; --code) {
+        if (XkbKeyNumSyms(xkb.get(), code) == 0) {
+            keycode = code;
+            break;
+        }
+    }
+    if (!keycode) {
+        qCWarning(DDE_SHELL) << "No spare keycode, can not break grabs";
+        return false;
+    }
+
+    XkbMapChangesRec changes;
+    memset(&changes, 0, sizeof(changes));
+    int types[XkbNumKbdGroups] = { XkbOneLevelIndex };
+    if (XkbChangeTypesOfKey(xkb.get(), keycode, 1, XkbGroup1Mask, types, &changes) != Success) {
+        qCWarning(DDE_SHELL) << "Failed to change key type, keycode:" << keycode;
+        return false;
+    }
+
+    KeySym *syms = XkbResizeKeySyms(xkb.get(), keycode, 1);
+    XkbAction *actions = XkbResizeKeyActions(xkb.get(), keycode, 1);
+    if (!syms || !actions) {
+        return false;
+    }
+    syms[0] = XF86XK_Ungrab;
+    memset(&actions[0], 0, sizeof(XkbAction));
+    actions[0].any.type = XkbSA_XFree86Private;
+    memcpy(actions[0].any.data, "Ungrab", strlen("Ungrab"));
+    // 不让服务端根据 interpret 重新计算这个键的动作
+    xkb->server->c_explicit[keycode] |= XkbExplicitInterpretMask;
+
+    changes.changed |= XkbKeySymsMask | XkbKeyActionsMask | XkbExplicitComponentsMask;
+    changes.first_key_sym = static_cast<KeyCode>(keycode);
+    changes.num_key_syms = 1;
+    changes.first_key_act = static_cast<KeyCode>(keycode);
+    changes.num_key_acts = 1;
+    changes.first_key_explicit = static_cast<KeyCode>(keycode);
+    changes.num_key_explicit = 1;
+    if (!XkbChangeMap(display.get(), xkb.get(), &changes)) {
+        qCWarning(DDE_SHELL) << "Failed to bind ungrab action, keycode:" << keycode;
+        return false;
+    }
+
+    // XTest 的事件在处理请求时立即分发，XSync 返回后抓取已经断开
+    XTestFakeKeyEvent(display.get(), static_cast<unsigned int>(keycode), True, CurrentTime);
+    XTestFakeKeyEvent(display.get(), static_cast<unsigned int>(keycode), False, CurrentTime);
+    XSync(display.get(), False);
+
+    changes.changed &= ~XkbKeyTypesMask;
+    if (!XkbChangeMap(display.get(), origin.get(), &changes)) {
+        qCWarning(DDE_SHELL) << "Failed to restore keyboard map, keycode:" << keycode;
+    }
+    XSync(display.get(), False);
+
+    return true;
+}
+
+}
 
 KeyboardPlatformWayland::KeyboardPlatformWayland(QObject *parent)
     : KeyBoardPlatform(parent)
@@ -164,7 +280,10 @@ void KeyboardPlatformWayland::initStatus()
 
 void KeyboardPlatformWayland::ungrabKeyboard()
 {
-    QProcess::execute("bash -c \"originmap=$(setxkbmap -query | grep option | awk -F ' ' '{print $2}');/usr/bin/setxkbmap -option grab:break_actions&&/usr/bin/xdotool key XF86Ungrab&&setxkbmap -option $originmap\"");
+    QElapsedTimer timer;
+    timer.start();
+    const bool result = breakXGrabs();
+    qCInfo(DDE_SHELL) << "Break grabs of X clients, result:" << result << ", elapsed:" << timer.elapsed() << "ms";
 }
 
 #endif
@@ -11,130 +11,99 @@
 #include <QX11Info>
 #endif
 #include <QDebug>
+#include <QSocketNotifier>
 
 #include <X11/X.h>
 #include <X11/XKBlib.h>
-#include <X11/extensions/XInput.h>
-#include <X11/extensions/XInput2.h>
 #include <X11/Xlib.h>
 #include <X11/keysym.h>
 #include <X11/extensions/XTest.h>
 
 #include <stdio.h>
 
-static int xi2_opcode;
-
-int KeyboardPlatformX11::xinput_version(Display *display)
+KeyboardPlatformX11::~KeyboardPlatformX11()
 {
-    XExtensionVersion *version;
-    static int vers = -1;
-
-    if (vers != -1)
-        return vers;
+    delete m_notifier;
+    if (m_monitorDisplay) {
+        XCloseDisplay(m_monitorDisplay);
+    }
+}
 
-    version = XGetExtensionVersion(display, INAME);
+/**
+ * @brief 开始监听大小写锁定和数字锁定状态
+ *
+ * 单独打开一个连接，只订阅 XKB 锁定修饰键变化的 StateNotify 事件，由 QSocketNotifier 在事件循环中读取，
+ * 不需要阻塞的线程，不论是按键、setNumLockStatus 还是其它程序修改的状态都能收到。
+ */
+void KeyboardPlatformX11::run()
+{
+    if (m_monitorDisplay) {
+        return;
+    }
 
-    if (version && (version != (XExtensionVersion*) NoSuchExtension)) {
-        vers = version->major_version;
-        XFree(version);
+    m_monitorDisplay = XOpenDisplay(nullptr);
+    if (!m_monitorDisplay) {
+        qCWarning(DDE_SHELL) << "Failed to open display for keyboard monitor";
+        return;
     }
 
-    /* Announce our supported version so the server treats us correctly. */
-    if (vers >= XI_2_Major)
-    {
-        const char *forced_version;
-        int maj = 2, min = 2;
-
-        forced_version = getenv("XINPUT_XI2_VERSION");
-        if (forced_version) {
-            if (sscanf(forced_version, "%d.%d", &maj, &min) != 2) {
-                fprintf(stderr, "Invalid format of XINPUT_XI2_VERSION "
-                                "environment variable. Need major.minor\n");
-                exit(1);
-            }
-            printf("Overriding XI2 version to: %d.%d\n", maj, min);
-        }
+    int opcode = 0;
+    int error = 0;
+    int major = XkbMajorVersion;
+    int minor = XkbMinorVersion;
+    if (!XkbQueryExtension(m_monitorDisplay, &opcode, &m_xkbEventBase, &error, &major, &minor)) {
+        qCWarning(DDE_SHELL) << "XKB extension is not available";
+        XCloseDisplay(m_monitorDisplay);
+        m_monitorDisplay = nullptr;
+        return;
+    }
 
-        XIQueryVersion(display, &maj, &min);
+    XkbSelectEventDetails(m_monitorDisplay, XkbUseCoreKbd, XkbStateNotify, XkbModifierLockMask, XkbModifierLockMask);
+    m_numLockMask = XkbKeysymToModifiers(m_monitorDisplay, XK_Num_Lock);
+    XkbStateRec state;
+    if (XkbGetState(m_monitorDisplay, XkbUseCoreKbd, &state) == Success) {
+        m_lockedMods = state.locked_mods;
     }
+    XFlush(m_monitorDisplay);
 
-    return vers;
+    m_notifier = new QSocketNotifier(ConnectionNumber(m_monitorDisplay), QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &KeyboardPlatformX11::processEvents);
+    processEvents();
 }
 
-void KeyboardPlatformX11::select_events(Display* display)
+void KeyboardPlatformX11::processEvents()
 {
-    XIEventMask m;
-    m.deviceid = XIAllMasterDevices;
-    m.mask_len = XIMaskLen(XI_LASTEVENT);
-    m.mask = (unsigned char*)calloc(m.mask_len, sizeof(char));
-
-    //    XISetMask(m.mask, XI_RawKeyPress);
-    XISetMask(m.mask, XI_RawKeyRelease);
-    //    XISetMask(m.mask, XI_RawButtonPress);
-    //    XISetMask(m.mask, XI_RawButtonRelease);
-    //    XISetMask(m.mask, XI_RawMotion);
-    //    XISetMask(m.mask, XI_RawTouchBegin);
-    //    XISetMask(m.mask, XI_RawTouchUpdate);
-    //    XISetMask(m.mask, XI_RawTouchEnd);
-
-    XISelectEvents(display, DefaultRootWindow(display), &m, 1);
-
-    free(m.mask);
-    XSync(display, False);
+    // XPending 会读取连接中已有的数据，不会阻塞
+    while (XPending(m_monitorDisplay) > 0) {
+        XEvent event;
+        XNextEvent(m_monitorDisplay, &event);
+        if (event.type != m_xkbEventBase) {
+            continue;
+        }
+
+        const XkbEvent *xkbEvent = reinterpret_cast<const XkbEvent *>(&event);
+        if (xkbEvent->any.xkb_type == XkbStateNotify) {
+            updateLockedMods(xkbEvent->state.locked_mods);
+        }
+    }
 }
 
-int KeyboardPlatformX11::listen(Display *display)
+void KeyboardPlatformX11::updateLockedMods(unsigned int lockedMods)
 {
-    Window root = DefaultRootWindow(display);
-    int root_x, root_y, nouse;
-    Window noused_window;
-    unsigned int mask;
-
-    while(1)
-    {
-        XEvent ev;
-        XGenericEventCookie *cookie = static_cast<XGenericEventCookie*>(&ev.xcookie);
-        XNextEvent(display, static_cast<XEvent*>(&ev));
-
-        if (XGetEventData(display, cookie) &&
-                cookie->type == GenericEvent &&
-                cookie->extension == xi2_opcode)
-        {
-            XQueryPointer(display, root, &noused_window, &noused_window, &root_x, &root_y, &nouse, &nouse, &mask);
-            XIRawEvent* event = static_cast<XIRawEvent*>(cookie->data);
-            switch (cookie->evtype)
-            {
-            case XI_RawButtonPress:
-                /*printf("Button press: Detail(%d), X(%d), Y(%d), Mask(%u)\n", event->detail, root_x, root_y, mask);*/
-                break;
-            case XI_RawButtonRelease:
-                /*printf("Button release: Detail(%d), X(%d), Y(%d), Mask(%u)\n", event->detail, root_x, root_y, mask);*/
-                break;
-            case XI_RawKeyPress:
-                break;
-            case XI_RawKeyRelease:
-                if (event->detail == 66) { // check if the key pressed is capslock first.
-                    emit capsLockStatusChanged(isCapsLockOn());
-                } else if (event->detail == 77) {
-                    emit numLockStatusChanged(isNumLockOn());
-                }
-                /*printf("Key release: Detail(%d), X(%d), Y(%d), Mask(%u)\n", event->detail, root_x, root_y, mask);*/
-                break;
-            case XI_RawTouchBegin:
-                //                printf("Touch begin: Detail(%d), X(%d), Y(%d), Mask(%u)\n", event->detail, root_x, root_y, mask);
-                break;
-            case XI_RawTouchUpdate:
-                //                printf("Touch update: Detail(%d), X(%d), Y(%d), Mask(%u)\n", event->detail, root_x, root_y, mask);
-                break;
-            case XI_RawTouchEnd:
-                //                printf("Touch end: Detail(%d), X(%d), Y(%d), Mask(%u)\n", event->detail, root_x, root_y, mask);
-                break;
-            }
-        }
+    const unsigned int changedMods = lockedMods ^ m_lockedMods;
+    m_lockedMods = lockedMods;
+
+    if (changedMods & LockMask) {
+        emit capsLockStatusChanged((lockedMods & LockMask) != 0);
+    }
 
-        XFreeEventData(display, cookie);
+    // 键盘映射可能在启动后才加载，数字锁定对应的修饰键为 0 时重新获取
+    if (!m_numLockMask) {
+        m_numLockMask = XkbKeysymToModifiers(m_monitorDisplay, XK_Num_Lock);
+    }
+    if (m_numLockMask && (changedMods & m_numLockMask)) {
+        emit numLockStatusChanged((lockedMods & m_numLockMask) != 0);
     }
-    return EXIT_SUCCESS;
 }
 
 #ifndef ENABLE_DSS_SNIPE
@@ -198,25 +167,6 @@ bool KeyboardPlatformX11::setNumLockStatus(const bool &on)
     return pressExit == 0 && releseExit == 0;
 }
 
-void KeyboardPlatformX11::run()
-{
-    Display* display = XOpenDisplay(nullptr);
-    int event, error;
-
-    if (!XQueryExtension(display, "XInputExtension", &xi2_opcode, &event, &error)) {
-        fprintf(stderr, "XInput2 not available.\n");
-        return;
-    }
-
-    if (!xinput_version(display)) {
-        fprintf(stderr, "XInput2 extension not available\n");
-        return;
-    }
-
-    select_events(display);
-    listen(display);
-}
-
 void KeyboardPlatformX11::ungrabKeyboard()
 {
     static Display *d = QX11Info::display();
@@ -287,25 +237,6 @@ bool KeyboardPlatformX11::setNumLockStatus(const bool &on)
     return pressExit == 0 && releseExit == 0;
 }
 
-void KeyboardPlatformX11::run()
-{
-    Display* display = XOpenDisplay(nullptr);
-    int event, error;
-
-    if (!XQueryExtension(display, "XInputExtension", &xi2_opcode, &event, &error)) {
-        fprintf(stderr, "XInput2 not available.\n");
-        return;
-    }
-
-    if (!xinput_version(display)) {
-        fprintf(stderr, "XInput2 extension not available\n");
-        return;
-    }
-
-    select_events(display);
-    listen(display);
-}
-
 void KeyboardPlatformX11::ungrabKeyboard()
 {
     if (!m_display) {
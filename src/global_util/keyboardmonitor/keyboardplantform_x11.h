@@ -7,6 +7,7 @@
 
 #include "keyboardplatform.h"
 
+class QSocketNotifier;
 typedef struct _XDisplay Display;
 
 class KeyboardPlatformX11 : public KeyBoardPlatform
@@ -14,6 +15,7 @@ class KeyboardPlatformX11 : public KeyBoardPlatform
     Q_OBJECT
 public:
     KeyboardPlatformX11(QObject *parent = nullptr);
+    ~KeyboardPlatformX11() override;
 
     bool isCapsLockOn() override;
     bool isNumLockOn() override;
@@ -22,9 +24,15 @@ public:
     void ungrabKeyboard() override;
 
 private:
-    int listen(Display *display);
-    static int xinput_version(Display *display);
-    static void select_events(Display* display);
+    void processEvents();
+    void updateLockedMods(unsigned int lockedMods);
+
+private:
+    Display *m_monitorDisplay = nullptr;  // 只用于接收 XKB 事件的连接
+    QSocketNotifier *m_notifier = nullptr;
+    int m_xkbEventBase = 0;
+    unsigned int m_lockedMods = 0;
+    unsigned int m_numLockMask = 0;
 
 #ifdef ENABLE_DSS_SNIPE
 private:
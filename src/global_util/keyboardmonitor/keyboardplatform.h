@@ -17,6 +17,7 @@ public:
     virtual bool isCapsLockOn() = 0;
     virtual bool isNumLockOn() = 0;
     virtual bool setNumLockStatus(const bool &on) = 0;
+    // 开始监听键盘状态，在主线程中调用，不能阻塞
     virtual void run() = 0;
     virtual void ungrabKeyboard() = 0;
 
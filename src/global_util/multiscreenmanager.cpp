@@ -13,10 +13,15 @@
 
 #include "dbusconstant.h"
 
+// 等待屏幕接入时每2s输出一次日志，100s后仍没有屏幕则不再输出
+static const int SCREEN_WATCHDOG_INTERVAL = 2 * 1000;
+static const int SCREEN_WATCHDOG_MAX_WAIT = 100 * 1000;
+
 MultiScreenManager::MultiScreenManager(QObject *parent)
     : QObject(parent)
     , m_registerFunction(nullptr)
     , m_raiseContentFrameTimer(new QTimer(this))
+    , m_screenWatchdogTimer(new QTimer(this))
     , m_systemDisplay(new SystemDisplayInter(DSS_DBUS::systemDisplayService, DSS_DBUS::systemDisplayPath, QDBusConnection::systemBus(), this))
     , m_isCopyMode(false)
 {
@@ -28,6 +33,9 @@ MultiScreenManager::MultiScreenManager(QObject *parent)
     m_raiseContentFrameTimer->setSingleShot(true);
 
     connect(m_raiseContentFrameTimer, &QTimer::timeout, this, &MultiScreenManager::raiseContentFrame);
+
+    m_screenWatchdogTimer->setInterval(SCREEN_WATCHDOG_INTERVAL);
+    connect(m_screenWatchdogTimer, &QTimer::timeout, this, &MultiScreenManager::onScreenWatchdogTimeout);
     connect(m_systemDisplay, &SystemDisplayInter::ConfigUpdated, this, &MultiScreenManager::onDisplayModeChanged);
     if (m_systemDisplay->isValid()) {
         m_isCopyMode = (COPY_MODE == getDisplayModeByConfig(m_systemDisplay->GetConfig()));
@@ -39,45 +47,69 @@ void MultiScreenManager::register_for_multi_screen(std::function<QWidget *(QScre
     m_registerFunction = function;
     qCInfo(DDE_SHELL) << "Copy mode:" << m_isCopyMode;
 
-    int maxAttempts = 0;
-    while (true) {
-        if (qApp->screens().count() < 1) {
-            // 没有屏幕数据延时2s再取一次
-            QThread::sleep(2);
-            qWarning(" #### qApp->screens : %d, repeat times : %d .", qApp->screens().count(),  maxAttempts++);
-            if (maxAttempts == 50) {
-                break;
-            }
-        } else {
-            break;
-        }
+    // 没有屏幕数据时不阻塞主线程等待，屏幕接入后在onScreenAdded中创建窗口，看门狗定时器只用于输出日志
+    if (screens().isEmpty()) {
+        qCWarning(DDE_SHELL) << "No screen available, wait for screen added";
+        startScreenWatchdog();
+        return;
     }
 
+    // 创建窗口只在主线程中做必须的部分，壁纸解码缩放在线程中并行处理，屏幕几何信息所有屏幕共享一次查询
+    QElapsedTimer timer;
+    timer.start();
+
     // update all screen
     if (m_isCopyMode) {
-        if (!qApp->screens().isEmpty()) {
-            QScreen *validScreen = nullptr;
-            for (QScreen *screen : qApp->screens()) {
-                // 留下一个可用的屏幕
-                if (!screen->name().isEmpty()) {
-                    validScreen = screen;
-                    break;
-                }
+        for (QScreen *screen : screens()) {
+            // 留下一个可用的屏幕
+            if (!screen->name().isEmpty()) {
+                onScreenAdded(screen);
+                break;
             }
-            if (!validScreen)
-                return;
-            onScreenAdded(validScreen);
         }
     } else {
-        for (QScreen *screen : qApp->screens()) {
+        for (QScreen *screen : screens()) {
             // 当greeter刚起来处理第一个屏幕时，第二个屏幕被拔掉，这时第二个屏幕指针被释放，不应该在继续处理，否则会导致崩溃
-            if (!qApp->screens().contains(screen)) {
+            if (!screens().contains(screen)) {
                 qCWarning(DDE_SHELL) << "Screen pointer has been released";
                 continue;
             }
             onScreenAdded(screen);
         }
     }
+
+    qCInfo(DDE_SHELL) << "Create frames finished, frame count:" << m_frames.size() << ", elapsed:" << timer.elapsed() << "ms";
+
+    // 只有虚拟屏幕时同样等待真实的屏幕接入
+    if (m_frames.isEmpty()) {
+        startScreenWatchdog();
+    }
+}
+
+QList<QScreen *> MultiScreenManager::screens() const
+{
+    return qApp->screens();
+}
+
+void MultiScreenManager::startScreenWatchdog()
+{
+    m_screenWaitTimer.start();
+    m_screenWatchdogTimer->start();
+}
+
+void MultiScreenManager::onScreenWatchdogTimeout()
+{
+    if (!m_frames.isEmpty()) {
+        m_screenWatchdogTimer->stop();
+        return;
+    }
+
+    qCWarning(DDE_SHELL) << "Still waiting for screen, screen count:" << screens().size()
+                         << ", waited:" << m_screenWaitTimer.elapsed() << "ms";
+    if (m_screenWaitTimer.elapsed() >= SCREEN_WATCHDOG_MAX_WAIT) {
+        qCCritical(DDE_SHELL) << "No screen available after" << m_screenWaitTimer.elapsed() << "ms, stop watchdog";
+        m_screenWatchdogTimer->stop();
+    }
 }
 
 void MultiScreenManager::startRaiseContentFrame(const bool visible)
@@ -128,6 +160,10 @@ void MultiScreenManager::onScreenAdded(QPointer<QScreen> screen)
     // 如果指针为空，则不加入Map中，并析构创建的全屏窗口。
     if (w && !screen.isNull()) {
         m_frames[screen] = w;
+        if (m_screenWatchdogTimer->isActive()) {
+            qCInfo(DDE_SHELL) << "Screen added after waiting" << m_screenWaitTimer.elapsed() << "ms";
+            m_screenWatchdogTimer->stop();
+        }
         // wayland下没有屏幕时，容易导致qt崩溃
         if (!QGuiApplication::platformName().startsWith("wayland", Qt::CaseInsensitive)) {
             w->installEventFilter(this);
@@ -8,6 +8,7 @@
 #include <QWidget>
 #include <QScreen>
 #include <QMap>
+#include <QElapsedTimer>
 #include <functional>
 
 #ifdef ENABLE_DSS_SNIPE
@@ -35,6 +36,7 @@ public:
 
 protected:
     bool eventFilter(QObject *watched, QEvent *event) override;
+    virtual QList<QScreen *> screens() const;
 
 private:
     void onScreenAdded(QPointer<QScreen> screen);
@@ -42,15 +44,19 @@ private:
     void raiseContentFrame();
     int getDisplayModeByConfig(const QString &config) const;
     void updateFrame();
+    void startScreenWatchdog();
 
 private slots:
     void onDisplayModeChanged(const QString &);
     void checkLockFrameLocation();
+    void onScreenWatchdogTimeout();
 
 private:
     std::function<QWidget* (QPointer<QScreen> , int)> m_registerFunction;
     QMap<QScreen*, QWidget*> m_frames;
     QTimer *m_raiseContentFrameTimer;
+    QTimer *m_screenWatchdogTimer;
+    QElapsedTimer m_screenWaitTimer;
     SystemDisplayInter *m_systemDisplay;
     bool m_isCopyMode;
 };
@@ -0,0 +1,381 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "nss_cache.h"
+#include "constants.h"
+
+#include <QApplication>
+#include <QDebug>
+#include <QMutexLocker>
+#include <QThread>
+#include <QVector>
+
+#include <cerrno>
+#include <grp.h>
+#include <pwd.h>
+#include <shadow.h>
+#include <unistd.h>
+
+static const int DEFAULT_TIME_TO_LIVE = 60 * 1000;
+static const int DEFAULT_BUFFER_SIZE = 16384;
+// 避免 NSS 模块异常时无限扩大缓冲区
+static const int MAX_BUFFER_SIZE = 16 * 1024 * 1024;
+static const int MAX_GROUP_COUNT = 65536;
+
+Q_GLOBAL_STATIC(NssCache, nssCache)
+
+namespace {
+
+/**
+ * @brief 在线程中批量查询，结果保存到缓存中
+ */
+class NssPrefetchThread : public QThread
+{
+public:
+    NssPrefetchThread(NssCache *cache, const QStringList &names)
+        : m_cache(cache)
+        , m_names(names)
+    {
+    }
+
+protected:
+    void run() override
+    {
+        // 域账户判断使用的用户组
+        m_cache->groupMembers("udcp");
+        for (const QString &name : m_names) {
+            if (isInterruptionRequested()) {
+                return;
+            }
+            m_cache->passwdByName(name);
+            m_cache->userGroups(name);
+        }
+    }
+
+private:
+    NssCache *m_cache;
+    QStringList m_names;
+};
+
+int initialBufferSize(int name)
+{
+    const long size = sysconf(name);
+    return size > 0 ? static_cast<int>(size) : DEFAULT_BUFFER_SIZE;
+}
+
+}
+
+NssCache::NssCache(QObject *parent)
+    : QObject(parent)
+    , m_timeToLive(DEFAULT_TIME_TO_LIVE)
+{
+    moveToThread(qApp->thread());
+    m_clock.start();
+}
+
+NssCache::~NssCache()
+{
+    for (QThread *thread : m_prefetchThreads) {
+        thread->requestInterruption();
+        thread->wait();
+        delete thread;
+    }
+}
+
+NssCache *NssCache::instance()
+{
+    return nssCache;
+}
+
+NssCache::Passwd NssCache::passwdByName(const QString &name)
+{
+    Passwd passwd;
+    if (find(m_passwdByName, name, passwd)) {
+        return passwd;
+    }
+
+    passwd = queryPasswd(name);
+    insert(m_passwdByName, name, passwd);
+    if (passwd.valid) {
+        insert(m_passwdByUid, passwd.uid, passwd);
+    }
+    return passwd;
+}
+
+NssCache::Passwd NssCache::passwdByUid(uid_t uid)
+{
+    Passwd passwd;
+    if (find(m_passwdByUid, uid, passwd)) {
+        return passwd;
+    }
+
+    passwd = queryPasswd(uid);
+    insert(m_passwdByUid, uid, passwd);
+    if (passwd.valid) {
+        insert(m_passwdByName, passwd.name, passwd);
+    }
+    return passwd;
+}
+
+/**
+ * @brief 用户组中显式列出的成员，不包含以该组为主组的用户
+ */
+QStringList NssCache::groupMembers(const QString &group)
+{
+    QStringList members;
+    if (find(m_groupMembers, group, members)) {
+        return members;
+    }
+
+    members = queryGroupMembers(group);
+    insert(m_groupMembers, group, members);
+    return members;
+}
+
+/**
+ * @brief 用户所在的全部用户组名称，包括主组，数量没有限制
+ */
+QStringList NssCache::userGroups(const QString &name)
+{
+    QStringList groups;
+    if (find(m_userGroups, name, groups)) {
+        return groups;
+    }
+
+    const Passwd passwd = passwdByName(name);
+    if (passwd.valid) {
+        for (gid_t gid : queryGroupIds(name, passwd.gid)) {
+            QString groupName;
+            if (!find(m_groupNames, gid, groupName)) {
+                groupName = queryGroupName(gid);
+                insert(m_groupNames, gid, groupName);
+            }
+            if (!groupName.isEmpty()) {
+                groups.append(groupName);
+            }
+        }
+    }
+    insert(m_userGroups, name, groups);
+    return groups;
+}
+
+/**
+ * @brief 影子密码中的密码有效期信息，需要 root 权限，没有权限时结果无效
+ *
+ * 修改密码后有效期立即变化，结果不缓存。
+ */
+NssCache::Shadow NssCache::shadow(const QString &name)
+{
+    return queryShadow(name);
+}
+
+/**
+ * @brief 在后台线程中查询用户的账户和用户组信息
+ *
+ * @param names 用户名列表
+ */
+void NssCache::prefetch(const QStringList &names)
+{
+    if (names.isEmpty()) {
+        return;
+    }
+
+    NssPrefetchThread *thread = new NssPrefetchThread(this, names);
+    m_prefetchThreads.append(thread);
+    connect(thread, &QThread::finished, this, [this, thread, names] {
+        m_prefetchThreads.removeOne(thread);
+        thread->deleteLater();
+        emit prefetched(names);
+    });
+    thread->start();
+}
+
+/**
+ * @brief 清空缓存，账户或用户组变化时调用
+ */
+void NssCache::invalidate()
+{
+    QMutexLocker locker(&m_mutex);
+    m_passwdByName.clear();
+    m_passwdByUid.clear();
+    m_groupMembers.clear();
+    m_userGroups.clear();
+    m_groupNames.clear();
+}
+
+/**
+ * @brief 设置缓存有效期，小于等于 0 时不缓存
+ *
+ * @param msecs 毫秒
+ */
+void NssCache::setTimeToLive(int msecs)
+{
+    QMutexLocker locker(&m_mutex);
+    m_timeToLive = msecs;
+}
+
+int NssCache::timeToLive() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_timeToLive;
+}
+
+template<typename Key, typename T>
+bool NssCache::find(const QHash<Key, Entry<T>> &hash, const Key &key, T &value) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = hash.constFind(key);
+    if (it == hash.constEnd() || it->expireTime <= m_clock.elapsed()) {
+        return false;
+    }
+
+    value = it->value;
+    return true;
+}
+
+template<typename Key, typename T>
+void NssCache::insert(QHash<Key, Entry<T>> &hash, const Key &key, const T &value)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_timeToLive <= 0) {
+        return;
+    }
+
+    hash.insert(key, { value, m_clock.elapsed() + m_timeToLive });
+}
+
+NssCache::Passwd NssCache::queryPasswd(const QString &name)
+{
+    Passwd passwd;
+    const QByteArray nameData = name.toLocal8Bit();
+    QByteArray buffer(initialBufferSize(_SC_GETPW_R_SIZE_MAX), Qt::Uninitialized);
+    struct passwd pw;
+    struct passwd *result = nullptr;
+    int ret = 0;
+    while ((ret = getpwnam_r(nameData.constData(), &pw, buffer.data(), static_cast<size_t>(buffer.size()), &result)) == ERANGE
+           && buffer.size() < MAX_BUFFER_SIZE) {
+        buffer.resize(buffer.size() * 2);
+    }
+
+    if (ret != 0 || !result) {
+        qCDebug(DDE_SHELL) << "Fetch password structure failed, username:" << name << ", error:" << ret;
+        return passwd;
+    }
+
+    passwd.valid = true;
+    passwd.name = QString::fromLocal8Bit(pw.pw_name);
+    passwd.uid = pw.pw_uid;
+    passwd.gid = pw.pw_gid;
+    return passwd;
+}
+
+NssCache::Passwd NssCache::queryPasswd(uid_t uid)
+{
+    Passwd passwd;
+    QByteArray buffer(initialBufferSize(_SC_GETPW_R_SIZE_MAX), Qt::Uninitialized);
+    struct passwd pw;
+    struct passwd *result = nullptr;
+    int ret = 0;
+    while ((ret = getpwuid_r(uid, &pw, buffer.data(), static_cast<size_t>(buffer.size()), &result)) == ERANGE
+           && buffer.size() < MAX_BUFFER_SIZE) {
+        buffer.resize(buffer.size() * 2);
+    }
+
+    if (ret != 0 || !result) {
+        qCDebug(DDE_SHELL) << "Fetch password structure failed, uid:" << uid << ", error:" << ret;
+        return passwd;
+    }
+
+    passwd.valid = true;
+    passwd.name = QString::fromLocal8Bit(pw.pw_name);
+    passwd.uid = pw.pw_uid;
+    passwd.gid = pw.pw_gid;
+    return passwd;
+}
+
+QStringList NssCache::queryGroupMembers(const QString &group)
+{
+    QStringList members;
+    const QByteArray groupData = group.toLocal8Bit();
+    QByteArray buffer(initialBufferSize(_SC_GETGR_R_SIZE_MAX), Qt::Uninitialized);
+    struct group gr;
+    struct group *result = nullptr;
+    int ret = 0;
+    // 成员很多的组需要较大的缓冲区
+    while ((ret = getgrnam_r(groupData.constData(), &gr, buffer.data(), static_cast<size_t>(buffer.size()), &result)) == ERANGE
+           && buffer.size() < MAX_BUFFER_SIZE) {
+        buffer.resize(buffer.size() * 2);
+    }
+
+    if (ret != 0 || !result) {
+        return members;
+    }
+
+    for (char **member = gr.gr_mem; member && *member; ++member) {
+        members.append(QString::fromLocal8Bit(*member));
+    }
+    return members;
+}
+
+QList<gid_t> NssCache::queryGroupIds(const QString &name, gid_t gid)
+{
+    const QByteArray nameData = name.toLocal8Bit();
+    QVector<gid_t> groups(32);
+    int count = groups.size();
+    // 缓冲区不够时 getgrouplist 返回 -1，并把 count 设置为需要的数量
+    while (getgrouplist(nameData.constData(), gid, groups.data(), &count) == -1) {
+        if (groups.size() >= MAX_GROUP_COUNT) {
+            qCWarning(DDE_SHELL) << "Too many groups, username:" << name;
+            break;
+        }
+        count = qBound(groups.size() * 2, count, MAX_GROUP_COUNT);
+        groups.resize(count);
+    }
+    groups.resize(qMin(count, groups.size()));
+
+    QList<gid_t> result;
+    result.reserve(groups.size());
+    for (gid_t groupId : groups) {
+        result.append(groupId);
+    }
+    return result;
+}
+
+QString NssCache::queryGroupName(gid_t gid)
+{
+    QByteArray buffer(initialBufferSize(_SC_GETGR_R_SIZE_MAX), Qt::Uninitialized);
+    struct group gr;
+    struct group *result = nullptr;
+    int ret = 0;
+    while ((ret = getgrgid_r(gid, &gr, buffer.data(), static_cast<size_t>(buffer.size()), &result)) == ERANGE
+           && buffer.size() < MAX_BUFFER_SIZE) {
+        buffer.resize(buffer.size() * 2);
+    }
+
+    return (ret == 0 && result) ? QString::fromLocal8Bit(gr.gr_name) : QString();
+}
+
+NssCache::Shadow NssCache::queryShadow(const QString &name)
+{
+    Shadow shadow;
+    const QByteArray nameData = name.toLocal8Bit();
+    QByteArray buffer(DEFAULT_BUFFER_SIZE, Qt::Uninitialized);
+    struct spwd sp;
+    struct spwd *result = nullptr;
+    int ret = 0;
+    while ((ret = getspnam_r(nameData.constData(), &sp, buffer.data(), static_cast<size_t>(buffer.size()), &result)) == ERANGE
+           && buffer.size() < MAX_BUFFER_SIZE) {
+        buffer.resize(buffer.size() * 2);
+    }
+
+    if (ret != 0 || !result) {
+        return shadow;
+    }
+
+    shadow.valid = true;
+    shadow.lastChange = sp.sp_lstchg;
+    shadow.maxDays = sp.sp_max;
+    shadow.warnDays = sp.sp_warn;
+    return shadow;
+}
@@ -0,0 +1,98 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef NSS_CACHE_H
+#define NSS_CACHE_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QStringList>
+
+#include <sys/types.h>
+
+class QThread;
+
+/**
+ * @brief 用户、用户组的查询缓存
+ *
+ * NSS 查询在域账户（LDAP、AD）环境下可能需要访问网络，界面线程每次直接调用会造成卡顿。
+ * 查询结果按有效期缓存，过期后下一次查询时重新获取，账户服务通知用户变化时清空缓存；
+ * prefetch() 在后台线程中批量查询，完成后发出 prefetched 信号。
+ * 影子密码中的密码有效期随时可能被修改，每次都直接查询，不缓存。
+ * 查询使用可重入的 *_r 接口，可以在任意线程中调用。
+ */
+class NssCache : public QObject
+{
+    Q_OBJECT
+public:
+    struct Passwd {
+        bool valid = false;
+        QString name;
+        uid_t uid = 0;
+        gid_t gid = 0;
+    };
+
+    struct Shadow {
+        bool valid = false;
+        long lastChange = 0; // 上次修改密码的日期，自 1970-01-01 起的天数
+        long maxDays = -1;   // 密码有效天数，-1 为永不过期
+        long warnDays = -1;  // 过期前提醒的天数
+    };
+
+    explicit NssCache(QObject *parent = nullptr);
+    ~NssCache() override;
+    static NssCache *instance();
+
+    Passwd passwdByName(const QString &name);
+    Passwd passwdByUid(uid_t uid);
+    QStringList groupMembers(const QString &group);
+    QStringList userGroups(const QString &name);
+    Shadow shadow(const QString &name);
+
+    void prefetch(const QStringList &names);
+    void invalidate();
+
+    void setTimeToLive(int msecs);
+    int timeToLive() const;
+
+signals:
+    void prefetched(const QStringList &names);
+
+private:
+    Q_DISABLE_COPY(NssCache)
+
+    template<typename T>
+    struct Entry {
+        T value;
+        qint64 expireTime;
+    };
+
+    template<typename Key, typename T>
+    bool find(const QHash<Key, Entry<T>> &hash, const Key &key, T &value) const;
+    template<typename Key, typename T>
+    void insert(QHash<Key, Entry<T>> &hash, const Key &key, const T &value);
+
+    static Passwd queryPasswd(const QString &name);
+    static Passwd queryPasswd(uid_t uid);
+    static QStringList queryGroupMembers(const QString &group);
+    static QList<gid_t> queryGroupIds(const QString &name, gid_t gid);
+    static QString queryGroupName(gid_t gid);
+    static Shadow queryShadow(const QString &name);
+
+private:
+    mutable QMutex m_mutex;
+    QElapsedTimer m_clock;
+    int m_timeToLive;
+    QHash<QString, Entry<Passwd>> m_passwdByName;
+    QHash<uid_t, Entry<Passwd>> m_passwdByUid;
+    QHash<QString, Entry<QStringList>> m_groupMembers;
+    QHash<QString, Entry<QStringList>> m_userGroups;
+    QHash<gid_t, Entry<QString>> m_groupNames;
+    QList<QThread *> m_prefetchThreads;
+};
+
+#endif // NSS_CACHE_H
@@ -3,7 +3,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "login_plugin.h"
-#include "public_func.h"
+#include "plugin_dispatcher.h"
 
 LoginPlugin::LoginPlugin(dss::module::BaseModuleInterface *module, QObject *parent)
     : PluginBase(module, parent)
@@ -12,172 +12,137 @@ LoginPlugin::LoginPlugin(dss::module::BaseModuleInterface *module, QObject *pare
 
 }
 
-bool LoginPlugin::isPluginEnabled()
+/**
+ * @brief 发送消息并返回结果中的 Data 字段
+ */
+QVariantMap LoginPlugin::messageData(const QVariantMap &message)
 {
-    QJsonObject message;
-    message["CmdType"] = "IsPluginEnabled";
+    const QVariantMap &result = PluginDispatcher::instance()->call(this, message);
+    auto it = result.constFind("Data");
+    if (it == result.constEnd()) {
+        qCWarning(DDE_SHELL) << "Result doesn't contains the 'data' field";
+        return QVariantMap();
+    }
+
+    return it.value().toMap();
+}
 
-    const QString &result = this->message(toJson(message));
-    qCDebug(DDE_SHELL) << key() << " get enabled state result: " << result;
-    const QJsonObject &dataObj = getDataObj(result);
+bool LoginPlugin::isPluginEnabled()
+{
+    const QVariantMap &dataObj = messageData({{"CmdType", "IsPluginEnabled"}});
+    qCDebug(DDE_SHELL) << key() << " get enabled state result: " << dataObj;
     if (dataObj.isEmpty() || !dataObj.contains("IsPluginEnabled"))
         return true;
 
-    return dataObj["IsPluginEnabled"].toBool(true);
+    // 和 json 接口一致，值不是布尔类型时视为启用
+    return QJsonValue::fromVariant(dataObj.value("IsPluginEnabled")).toBool(true);
 }
 
 int LoginPlugin::level()
 {
-    QJsonObject message {
-        {"CmdType", "GetLevel"}
-    };
-
-    const QString &result = this->message(toJson(message));
-    const QJsonObject &dataObj = getDataObj(result);
-    if (!dataObj.contains("Level")) {
-        return 1;
-    }
-
-    return dataObj["Level"].toInt(1);
+    const QVariantMap &dataObj = messageData({{"CmdType", "GetLevel"}});
+    return dataObj.value("Level", 1).toInt();
 }
 
 int LoginPlugin::loginType()
 {
-    QJsonObject message {
-        {"CmdType", "GetLoginType"}
-    };
-
-    const QString &result = this->message(toJson(message));
-    qCDebug(DDE_SHELL) << "Login type, result: " << result;
-    const QJsonObject &dataObj = getDataObj(result);
-    if (!dataObj.contains("LoginType")) {
-        return CustomLoginType::CLT_Default;
-    }
-
-    return dataObj["LoginType"].toInt(CustomLoginType::CLT_Default);
+    const QVariantMap &dataObj = messageData({{"CmdType", "GetLoginType"}});
+    qCDebug(DDE_SHELL) << "Login type, result: " << dataObj;
+    return dataObj.value("LoginType", CustomLoginType::CLT_Default).toInt();
 }
 
 bool LoginPlugin::hasSecondLevel(const QString &user)
 {
-    QJsonObject message {
+    const QVariantMap &dataObj = messageData({
         {"CmdType", "HasSecondLevel"},
         {"Data", user}
-    };
-
-    const QString &result = this->message(toJson(message));
-    const QJsonObject &dataObj = getDataObj(result);
-    if (!dataObj.contains("HasSecondLevel")) {
-        return false;
-    }
-
-    return dataObj["HasSecondLevel"].toBool(false);
+    });
+    return dataObj.value("HasSecondLevel", false).toBool();
 }
 
 int LoginPlugin::updateLoginType()
 {
-    QJsonObject message {
-        {"CmdType", "UpdateLoginType"}
-    };
-
-    const QString &result = this->message(toJson(message));
-    qCDebug(DDE_SHELL) << "Update login type, result: " << result;
-    const QJsonObject &dataObj = getDataObj(result);
-    if (!dataObj.contains("LoginType")) {
-        return CustomLoginType::CLT_Default;
-    }
-
-    return dataObj["LoginType"].toInt(CustomLoginType::CLT_Default);
+    const QVariantMap &dataObj = messageData({{"CmdType", "UpdateLoginType"}});
+    qCDebug(DDE_SHELL) << "Update login type, result: " << dataObj;
+    return dataObj.value("LoginType", CustomLoginType::CLT_Default).toInt();
 }
 
 int LoginPlugin::sessionTimeout()
 {
-    QJsonObject message {
-        {"CmdType", "GetSessionTimeout"}
-    };
-
-    const QString &result = this->message(toJson(message));
-    qCDebug(DDE_SHELL) << "Get session timeout, result: " << result;
-    const QJsonObject &dataObj = getDataObj(result);
-    if (!dataObj.contains("SessionTimeout")) {
-        return DEFAULT_SESSION_TIMEOUT;
-    }
-
-    return dataObj["SessionTimeout"].toInt(DEFAULT_SESSION_TIMEOUT);
+    const QVariantMap &dataObj = messageData({{"CmdType", "GetSessionTimeout"}});
+    qCDebug(DDE_SHELL) << "Get session timeout, result: " << dataObj;
+    return dataObj.value("SessionTimeout", DEFAULT_SESSION_TIMEOUT).toInt();
 }
 
 bool LoginPlugin::supportDefaultUser()
 {
-    QJsonObject message;
-    message["CmdType"] = "GetConfigs";
-    const QString &result = this->message(toJson(message));
-    const QJsonObject &dataObj = getDataObj(result);
+    const QVariantMap &dataObj = messageData({{"CmdType", "GetConfigs"}});
     if (dataObj.isEmpty())
         return true;
 
-    return dataObj["SupportDefaultUser"].toBool(true);
+    return dataObj.value("SupportDefaultUser", true).toBool();
 }
 
 void LoginPlugin::notifyCurrentUserChanged(const QString &userName, uid_t uid)
 {
-    QJsonObject message;
-    message["CmdType"] = "CurrentUserChanged";
-    QJsonObject user;
-    user["Name"] = userName;
-    user["Uid"] = static_cast<int>(uid);
-    message["Data"] = user;
-
-    this->message(toJson(message));
+    const QVariantMap user {
+        {"Name", userName},
+        {"Uid", static_cast<int>(uid)}
+    };
+    PluginDispatcher::instance()->notify(this, {
+        {"CmdType", "CurrentUserChanged"},
+        {"Data", user}
+    });
 }
 
 void LoginPlugin::updateConfig()
 {
-    QJsonObject message;
-    message["CmdType"] = "GetConfigs";
-    QString result = this->message(toJson(message));
+    const QVariantMap &result = PluginDispatcher::instance()->call(this, {{"CmdType", "GetConfigs"}});
     qCInfo(DDE_SHELL) << "Get configs result: " << result;
-
-    QJsonParseError jsonParseError;
-    const QJsonDocument resultDoc = QJsonDocument::fromJson(result.toLatin1(), &jsonParseError);
-    if (jsonParseError.error != QJsonParseError::NoError || resultDoc.isEmpty()) {
-        qCWarning(DDE_SHELL) << "Result json parse error, error: " << jsonParseError.error;
-        return;
-    }
-
-    QJsonObject resultObj = resultDoc.object();
-    if (!resultObj.contains("Data")) {
+    if (!result.contains("Data")) {
         qCWarning(DDE_SHELL) << "Result doesn't contains the 'data' field";
         return;
     }
 
-    QJsonObject dataObj = resultObj["Data"].toObject();
-    m_pluginConfig.showAvatar = dataObj["ShowAvatar"].toBool(m_pluginConfig.showAvatar);
-    m_pluginConfig.showUserName = dataObj["ShowUserName"].toBool(m_pluginConfig.showUserName);
-    m_pluginConfig.showSwitchButton = dataObj["ShowSwitchButton"].toBool(m_pluginConfig.showSwitchButton);
-    m_pluginConfig.showLockButton = dataObj["ShowLockButton"].toBool(m_pluginConfig.showLockButton);
-    m_pluginConfig.defaultAuthLevel = (DefaultAuthLevel)dataObj["DefaultAuthLevel"].toInt();
-    m_pluginConfig.showBackGroundColor = dataObj["ShowBackGroundColor"].toBool(m_pluginConfig.showBackGroundColor);
-    m_pluginConfig.switchUserWhenCheckAccount = dataObj["SwitchUserWhenCheckAccount"].toBool(m_pluginConfig.switchUserWhenCheckAccount);
-    m_pluginConfig.notUsedByLoginedUserInGreeter = dataObj["NotUsedByLoginedUserInGreeter"].toBool(m_pluginConfig.notUsedByLoginedUserInGreeter);
-    m_pluginConfig.saveLastAuthType = dataObj["SaveLastAuthType"].toBool(m_pluginConfig.saveLastAuthType);
+    const QVariantMap &dataObj = result["Data"].toMap();
+    m_pluginConfig.showAvatar = dataObj.value("ShowAvatar", m_pluginConfig.showAvatar).toBool();
+    m_pluginConfig.showUserName = dataObj.value("ShowUserName", m_pluginConfig.showUserName).toBool();
+    m_pluginConfig.showSwitchButton = dataObj.value("ShowSwitchButton", m_pluginConfig.showSwitchButton).toBool();
+    m_pluginConfig.showLockButton = dataObj.value("ShowLockButton", m_pluginConfig.showLockButton).toBool();
+    m_pluginConfig.defaultAuthLevel = (DefaultAuthLevel)dataObj.value("DefaultAuthLevel").toInt();
+    m_pluginConfig.showBackGroundColor = dataObj.value("ShowBackGroundColor", m_pluginConfig.showBackGroundColor).toBool();
+    m_pluginConfig.switchUserWhenCheckAccount = dataObj.value("SwitchUserWhenCheckAccount", m_pluginConfig.switchUserWhenCheckAccount).toBool();
+    m_pluginConfig.notUsedByLoginedUserInGreeter = dataObj.value("NotUsedByLoginedUserInGreeter", m_pluginConfig.notUsedByLoginedUserInGreeter).toBool();
+    m_pluginConfig.saveLastAuthType = dataObj.value("SaveLastAuthType", m_pluginConfig.saveLastAuthType).toBool();
     if (dataObj.contains("AssignAuthType"))
         m_pluginConfig.assignAuthType = static_cast<AuthCommon::AuthType>(dataObj["AssignAuthType"].toInt());
-    m_authType = (AuthType)dataObj["AuthType"].toInt();
+    m_authType = (AuthType)dataObj.value("AuthType").toInt();
 }
 
 void LoginPlugin::accountError()
 {
-    QJsonObject jsonObject;
-    jsonObject["CmdType"] = "AccountError";
-    this->message(toJson(jsonObject));
+    PluginDispatcher::instance()->call(this, {{"CmdType", "AccountError"}});
 }
 
 void LoginPlugin::notifyAuthFactorsChanged(int authFactors)
 {
-    QJsonObject message;
-    message["CmdType"] = "AuthFactorsChanged";
-    QJsonObject data;
-    data["AuthFactors"] = authFactors;
-    message["Data"] = data;
+    const QVariantMap data {
+        {"AuthFactors", authFactors}
+    };
+    PluginDispatcher::instance()->notify(this, {
+        {"CmdType", "AuthFactorsChanged"},
+        {"Data", data}
+    });
+}
 
-    this->message(toJson(message));
+void LoginPlugin::notifyAuthState(int authType, int authState)
+{
+    const QVariantMap data {
+        {"AuthType", authType},
+        {"AuthState", authState}
+    };
+    PluginDispatcher::instance()->notify(this, {
+        {"CmdType", "AuthState"},
+        {"Data", data}
+    });
 }
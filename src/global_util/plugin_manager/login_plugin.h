@@ -6,11 +6,12 @@
 #define LOGIN_PLUGIN_H
 
 #include "plugin_base.h"
-#include "login_module_interface_v2.h"
+#include "login_module_interface_v3.h"
 #include "authcommon.h"
 
 #include <QObject>
 #include <QJsonObject>
+#include <QVariantMap>
 
 #define DEFAULT_SESSION_TIMEOUT 15000
 
@@ -24,6 +25,7 @@ public:
     using DefaultAuthLevel = dss::module::DefaultAuthLevel;
     using AuthType = dss::module::AuthType;
     using CustomLoginType = dss::module::CustomLoginType;
+    using StructuredMessageCallbackFunc = dss::module_v3::StructuredMessageCallbackFunc;
 
     // 认证插件配置
     struct PluginConfig
@@ -77,6 +79,14 @@ public:
 
     virtual void reset() = 0;
 
+    using PluginBase::message;
+    /**
+     * @brief 发送结构化消息，3.0.0 及以上的插件直接传递，旧插件转换为 json 字符串
+     */
+    virtual QVariantMap message(const QVariantMap &message) = 0;
+
+    virtual void setStructuredMessageCallback(StructuredMessageCallbackFunc) {}
+
     bool isPluginEnabled();
 
     int level(); // 插件所处层级
@@ -95,6 +105,8 @@ public:
 
     void notifyAuthFactorsChanged(int authFactors);
 
+    void notifyAuthState(int authType, int authState);
+
     void updateConfig();
 
     void accountError();
@@ -103,6 +115,9 @@ public:
 
     inline PluginConfig pluginConfig() const { return m_pluginConfig; }
 
+private:
+    QVariantMap messageData(const QVariantMap &message);
+
 private:
     PluginConfig m_pluginConfig;
     AuthType m_authType;
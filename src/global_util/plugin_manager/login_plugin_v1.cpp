@@ -2,6 +2,7 @@
 //
 // SPDX-License-Identifier: GPL-3.0-or-later
 #include "login_plugin_v1.h"
+#include "login_plugin_v2.h"
 
 #include <QDebug>
 
@@ -60,6 +61,11 @@ QString LoginPluginV1::message(const QString & msg)
     return QString::fromStdString(loginPlugin->onMessage(msg.toStdString()));
 }
 
+QVariantMap LoginPluginV1::message(const QVariantMap &msg)
+{
+    return LoginPlugin_V2::fromJsonMessage(message(LoginPlugin_V2::toJsonMessage(msg)));
+}
+
 void LoginPluginV1::setAuthCallback(LoginPlugin::AuthCallbackFun func)
 {
     TO_LOGIN_PLUGIN
@@ -29,6 +29,8 @@ public:
 
     virtual QString message(const QString &) override;
 
+    virtual QVariantMap message(const QVariantMap &) override;
+
     virtual void setAuthCallback(LoginPlugin::AuthCallbackFun) override;
 
     virtual void reset() override;
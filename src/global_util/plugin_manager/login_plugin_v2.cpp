@@ -2,12 +2,32 @@
 //
 // SPDX-License-Identifier: GPL-3.0-or-later
 #include "login_plugin_v2.h"
+#include "public_func.h"
+
+#include <QJsonDocument>
 
 namespace LoginPlugin_V2 {
 
 #define TO_LOGIN_PLUGIN_V2 \
     dss::module_v2::LoginModuleInterfaceV2* pluginV2 = dynamic_cast<dss::module_v2::LoginModuleInterfaceV2 *>(m_plugin);
 
+QString toJsonMessage(const QVariantMap &message)
+{
+    return toJson(QJsonObject::fromVariantMap(message));
+}
+
+QVariantMap fromJsonMessage(const QString &message)
+{
+    QJsonParseError jsonParseError;
+    const QJsonDocument &doc = QJsonDocument::fromJson(message.toUtf8(), &jsonParseError);
+    if (jsonParseError.error != QJsonParseError::NoError || !doc.isObject()) {
+        qCWarning(DDE_SHELL) << "Message json parse error, error: " << jsonParseError.errorString();
+        return QVariantMap();
+    }
+
+    return doc.object().toVariantMap();
+}
+
 LoginPluginV2::LoginPluginV2(dss::module_v2::LoginModuleInterfaceV2 * module, QObject *parent)
     : LoginPlugin(module, parent)
 {
@@ -64,6 +84,19 @@ QString LoginPluginV2::message(const QString & msg)
     return pluginV2->message(msg);
 }
 
+/**
+ * @brief 兼容 2.0.0 的插件，结构化消息转换为 json 字符串发送，返回的 json 字符串再转换回来
+ */
+QVariantMap LoginPluginV2::message(const QVariantMap &msg)
+{
+    TO_LOGIN_PLUGIN_V2
+
+    if (!pluginV2)
+        return QVariantMap();
+
+    return fromJsonMessage(pluginV2->message(toJsonMessage(msg)));
+}
+
 void LoginPluginV2::setAuthCallback(AuthCallbackFun func)
 {
     TO_LOGIN_PLUGIN_V2
@@ -13,6 +13,12 @@ namespace LoginPlugin_V2 {
 
 const QString API_VERSION = "2.0.0";
 
+/**
+ * @brief 2.0.0 及以下的插件只支持 json 字符串消息，结构化消息通过这两个函数转换
+ */
+QString toJsonMessage(const QVariantMap &message);
+QVariantMap fromJsonMessage(const QString &message);
+
 class LoginPluginV2 : public LoginPlugin
 {
     Q_OBJECT
@@ -29,6 +35,8 @@ public:
 
     virtual QString message(const QString &) override;
 
+    virtual QVariantMap message(const QVariantMap &) override;
+
     virtual void setAuthCallback(AuthCallbackFun) override;
 
     virtual void reset() override;
@@ -0,0 +1,37 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+#include "login_plugin_v3.h"
+
+namespace LoginPlugin_V3 {
+
+#define TO_LOGIN_PLUGIN_V3 \
+    dss::module_v3::LoginModuleInterfaceV3* pluginV3 = dynamic_cast<dss::module_v3::LoginModuleInterfaceV3 *>(m_plugin);
+
+LoginPluginV3::LoginPluginV3(dss::module_v3::LoginModuleInterfaceV3 * module, QObject *parent)
+    : LoginPluginV2(module, parent)
+{
+
+}
+
+QVariantMap LoginPluginV3::message(const QVariantMap &msg)
+{
+    TO_LOGIN_PLUGIN_V3
+
+    if (!pluginV3)
+        return LoginPluginV2::message(msg);
+
+    return pluginV3->message(msg);
+}
+
+void LoginPluginV3::setStructuredMessageCallback(StructuredMessageCallbackFunc func)
+{
+    TO_LOGIN_PLUGIN_V3
+
+    if (!pluginV3)
+        return;
+
+    pluginV3->setStructuredMessageCallback(func);
+}
+
+} // namespace LoginPlugin_V3
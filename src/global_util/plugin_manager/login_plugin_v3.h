@@ -0,0 +1,33 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+#ifndef LOGIN_PLUGIN_V3_H
+#define LOGIN_PLUGIN_V3_H
+
+#include "login_plugin_v2.h"
+#include "login_module_interface_v3.h"
+
+#include <QObject>
+
+namespace LoginPlugin_V3 {
+
+const QString API_VERSION = "3.0.0";
+
+/**
+ * @brief 3.0.0 的登录插件，结构化消息直接传递给插件，不经过 json 转换
+ */
+class LoginPluginV3 : public LoginPlugin_V2::LoginPluginV2
+{
+    Q_OBJECT
+public:
+    explicit LoginPluginV3(dss::module_v3::LoginModuleInterfaceV3 *module, QObject *parent = nullptr);
+
+    using LoginPlugin_V2::LoginPluginV2::message;
+    virtual QVariantMap message(const QVariantMap &) override;
+
+    virtual void setStructuredMessageCallback(StructuredMessageCallbackFunc) override;
+};
+
+} // namespace LoginPlugin_V3
+
+#endif // LOGIN_PLUGIN_V3_H
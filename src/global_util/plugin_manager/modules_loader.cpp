@@ -10,9 +10,14 @@
 
 #include <QApplication>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QLibrary>
 #include <QMutexLocker>
-#include <QDBusInterface>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusPendingReply>
+#include <QDBusVariant>
+#include <QProcess>
 
 #include <unistd.h>
 
@@ -21,12 +26,20 @@ const QString ModulesConfigDir = "/usr/lib/dde-session-shell/modules/config.d/";
 const QString LOWEST_VERSION = "1.1.0";
 const QString LoginType = "Login";
 const QString TrayType = "Tray";
+const int DBUS_PROBE_TIMEOUT = 3000;
+const int SHELL_PROBE_TIMEOUT = 5000;
 
 ModulesLoader::ModulesLoader(QObject* parent)
     : QThread(parent)
     , m_loadLoginModule(false)
     , m_model(nullptr)
 {
+    // 加载过程中又有插件需要重新判断时，结束后再处理
+    connect(this, &QThread::finished, this, [this] {
+        QMutexLocker locker(&m_mutex);
+        if (!m_pendingModules.isEmpty())
+            start(QThread::LowestPriority);
+    });
 }
 
 ModulesLoader::~ModulesLoader()
@@ -49,10 +62,21 @@ ModulesLoader& ModulesLoader::instance()
 
 void ModulesLoader::run()
 {
-    findModule(ModulesDir);
+    QSet<QString> targets;
+    {
+        QMutexLocker locker(&m_mutex);
+        targets.swap(m_pendingModules);
+    }
+    findModule(ModulesDir, targets);
 }
 
-void ModulesLoader::findModule(const QString& path)
+/**
+ * @brief 查找并加载插件
+ *
+ * @param path 插件目录
+ * @param targets 只重新判断这些插件，为空时处理目录中所有的插件
+ */
+void ModulesLoader::findModule(const QString& path, const QSet<QString> &targets)
 {
     QDir dir(path);
     if (!dir.exists()) {
@@ -60,20 +84,52 @@ void ModulesLoader::findModule(const QString& path)
         return;
     }
 
+    QElapsedTimer timer;
+    timer.start();
     auto blackList = DConfigHelper::instance()->getConfig("pluginBlackList", QStringList()).toStringList();
     qCInfo(DDE_SHELL) << "Find module, plugin black list:" << blackList;
-    const QFileInfoList modules = dir.entryInfoList();
-    for (QFileInfo module : modules) {
+    QFileInfoList modules;
+    QSet<QString> modulePaths;
+    QMap<QString, EnableProbe> probes;
+    for (const QFileInfo &module : dir.entryInfoList(QDir::Files)) {
         const QString path = module.absoluteFilePath();
         if (!QLibrary::isLibrary(path)) {
             continue;
         }
+        modulePaths.insert(path);
+        if (!targets.isEmpty() && !targets.contains(path)) {
+            continue;
+        }
+        modules.append(module);
+        probes.insert(path, readEnableProbe(module));
+    }
+
+    // 所有插件的判断条件同时执行，总耗时取决于最慢的一个，而不是所有条件的耗时之和
+    const QHash<QString, bool> enabledStates = runEnableProbes(probes);
+
+    if (m_metaIndex.size() == 0) {
+        m_metaIndex.load();
+    }
+    m_metaIndex.retain(modulePaths);
+
+    for (const QFileInfo &module : modules) {
+        const QString path = module.absoluteFilePath();
 
         // 检查是否要加载插件
-        if (!isPluginEnabled(module)) {
+        if (!enabledStates.value(path, true)) {
             qCInfo(DDE_SHELL) << "The plugin dose not want to be loaded, path:" << path;
-            // Unload 后再次加载插件会导致插件不显示，且 unload不会降低内存，意义不大
-            // QMetaObject::invokeMethod(this, "unloadPlugin", Qt::QueuedConnection, Q_ARG(QString, path));
+            // Unload 后再次加载插件会导致插件不显示，且 unload不会降低内存，意义不大，
+            // 所以只从插件管理中移除，保留已经加载的库，再次启用时直接使用
+            if (!targets.isEmpty() && contains(path) && !isParked(path)) {
+                QMetaObject::invokeMethod(this, "parkPlugin", Qt::QueuedConnection, Q_ARG(QString, path));
+            }
+            continue;
+        }
+
+        if (isParked(path)) {
+            PluginMetaIndex::Entry metaEntry;
+            m_metaIndex.find(module, metaEntry);
+            QMetaObject::invokeMethod(this, "restorePlugin", Qt::QueuedConnection, Q_ARG(QString, path), Q_ARG(QString, metaEntry.api), Q_ARG(bool, metaEntry.threadSafe));
             continue;
         }
 
@@ -86,19 +142,28 @@ void ModulesLoader::findModule(const QString& path)
         qCInfo(DDE_SHELL) << "About to process " << module;
         auto loader = std::unique_ptr<QPluginLoader>(new QPluginLoader(path));
 
+        // 元数据优先从索引中获取，不需要读取插件文件
+        PluginMetaIndex::Entry metaEntry;
+        if (!m_metaIndex.find(module, metaEntry)) {
+            const QJsonObject meta = loader->metaData().value("MetaData").toObject();
+            metaEntry.api = meta.value("api").toString();
+            metaEntry.pluginType = meta.value("pluginType").toString();
+            metaEntry.threadSafe = meta.value("threadSafe").toBool(false);
+            m_metaIndex.insert(module, metaEntry);
+        }
+
         // 检查兼容性
-        const QJsonObject meta = loader->metaData().value("MetaData").toObject();
-        const QString version = meta.value("api").toString();
+        const QString version = metaEntry.api;
         // 版本过低则不加载，可能会导致登录器崩溃
         if (!checkVersion(version, LOWEST_VERSION)) {
             qCWarning(DDE_SHELL) << "The module version is too low, version:" << version << ", lowest version:" << LOWEST_VERSION;
             continue;
         }
 
-        // 性能优化，分类加载
-        QString pluginType = meta.value("pluginType").toString();
+        // 性能优化，分类加载，只重新判断部分插件时不区分类型
+        const QString pluginType = metaEntry.pluginType;
         if (!pluginType.isEmpty()) {
-            if ((pluginType == LoginType && !m_loadLoginModule) || (pluginType == TrayType && m_loadLoginModule)) {
+            if (targets.isEmpty() && ((pluginType == LoginType && !m_loadLoginModule) || (pluginType == TrayType && m_loadLoginModule))) {
                 continue;
             }
         } else {
@@ -106,6 +171,18 @@ void ModulesLoader::findModule(const QString& path)
             qCInfo(DDE_SHELL) << "Old plugin has no pluginType in json file:" << module;
         }
 
+        // 之前加载过的插件已经知道 key，在黑名单中或者已经加载的插件不需要再 dlopen
+        if (!metaEntry.key.isEmpty()) {
+            if (blackList.contains(metaEntry.key)) {
+                qCInfo(DDE_SHELL) << "The plugin is in black list, won't be loaded, key:" << metaEntry.key;
+                continue;
+            }
+            if (PluginManager::instance()->contains(metaEntry.key)) {
+                qCInfo(DDE_SHELL) << "The plugin has been loaded, key:" << metaEntry.key;
+                continue;
+            }
+        }
+
         auto* moduleInstance = dynamic_cast<dss::module::BaseModuleInterface*>(loader->instance());
         if (!moduleInstance) {
             qCWarning(DDE_SHELL) << "Load plugin failed, error:" << loader->errorString();
@@ -114,6 +191,7 @@ void ModulesLoader::findModule(const QString& path)
         }
 
         qCInfo(DDE_SHELL) << "Current plugin key:" << moduleInstance->key();
+        m_metaIndex.setKey(module, moduleInstance->key());
         if (blackList.contains(moduleInstance->key())) {
             qCInfo(DDE_SHELL) << "The plugin is in black list, won't be loaded.";
             loader->unload();
@@ -142,14 +220,21 @@ void ModulesLoader::findModule(const QString& path)
         QMutexLocker locker(&m_mutex);
         m_pluginLoaders.insert(moduleInstance->key(), QPointer<QPluginLoader>(loader.get()));
         loader.release(); // 释放所有权，防止 QPluginLoader 被析构
-        PluginManager::instance()->addPlugin(moduleInstance, version);
+        PluginManager::instance()->addPlugin(moduleInstance, version, metaEntry.threadSafe);
     }
-    m_loadLoginModule = true;
+
+    if (m_metaIndex.isDirty()) {
+        m_metaIndex.save();
+    }
+    qCInfo(DDE_SHELL) << "Find module finished, plugin count:" << modules.size() << ", elapsed:" << timer.elapsed() << "ms";
+
+    if (targets.isEmpty())
+        m_loadLoginModule = true;
     Q_EMIT loadPluginsFinished();
 }
 
 /**
- * @brief 获取插件是否需要被加载，在插件被 load 之前就可以判断，默认返回 true
+ * @brief 获取插件是否需要被加载的判断条件，在插件被 load 之前就可以判断，没有配置时直接加载
  * 从 /usr/lib/dde-session-shell/modules/config.d 文件夹中获取和插件同名（去掉lib后）的 json 文件，从 json 文件中获取 dconfig 的配置信息
  * json 文件示例：
  * "pluginEnabled": {
@@ -163,11 +248,13 @@ void ModulesLoader::findModule(const QString& path)
  *            }
  *        },
  *        "greeter": {
- *            "shell": "/usr/bin/check-wechat-auth-enabled.sh"
+ *            "shell": "/usr/bin/check-wechat-auth-enabled.sh",
+ *            "timeout": 3000
  *        },
  * }
  * `lock`字段表明这个配置适用于锁屏界面；`greeter`字段表明这个配置适用于登录界面
  * `dbusProperty`字段表明需要通过 dbus 获取属性，并且可以监听属性变化；`shell`字段表明是一个 shell 命令，执行命令获取返回值，0 是加载，其它不加载。
+ * `timeout`是可选的超时时间（毫秒），超时后不加载插件，默认 dbusProperty 为 3 秒，shell 为 5 秒。
  *
  * 另外还支持 dconfig 类型，例如：
  *
@@ -186,24 +273,24 @@ void ModulesLoader::findModule(const QString& path)
 
  *
  * @param module 插件文件信息
- * @return true 需要被加载
- * @return false 不需要被加载
+ * @return 判断条件
  */
-bool ModulesLoader::isPluginEnabled(const QFileInfo& module)
+ModulesLoader::EnableProbe ModulesLoader::readEnableProbe(const QFileInfo& module) const
 {
+    EnableProbe probe;
     QString configFileName = module.baseName();
     if (configFileName.startsWith("lib")) {
         configFileName = configFileName.right(configFileName.length() - 3);
     }
     const QString configFile = ModulesConfigDir + configFileName + ".json";
     if (!QFile::exists(configFile))
-        return true;
+        return probe;
 
     qCInfo(DDE_SHELL) << "Find module config file:" << configFile;
     QFile f(configFile);
     if (!f.open(QIODevice::ReadOnly)) {
         qCWarning(DDE_SHELL) << "Open module config file failed.";
-        return true;
+        return probe;
     }
 
     QJsonParseError parseError;
@@ -211,108 +298,186 @@ bool ModulesLoader::isPluginEnabled(const QFileInfo& module)
     f.close();
     if (doc.isNull() || parseError.error != QJsonParseError::NoError) {
         qCWarning(DDE_SHELL) << "Parse module config file failed, error:" << parseError.errorString();
-        return true;
+        return probe;
     }
 
     // 执行到下面的阶段，那么认定插件是必须要通过判断后才能加载的，一旦出现异常则不加载插件
     const auto& obj = doc.object();
-    if (obj.contains("pluginEnabled")) {
-        const auto& enabledObj = obj.value("pluginEnabled").toObject();
-        if (enabledObj.isEmpty()) {
+    if (!obj.contains("pluginEnabled"))
+        return probe;
+
+    probe.type = EnableProbe::Never;
+    const auto& enabledObj = obj.value("pluginEnabled").toObject();
+    if (enabledObj.isEmpty()) {
+        qCWarning(DDE_SHELL) << "Check load state is not valid.";
+        return probe;
+    }
+    qCDebug(DDE_SHELL) << "Plugin enabled object:" << enabledObj;
+    const auto appType = qApp->property("dssAppType").toInt();
+    QString configField = appType == APP_TYPE_LOCK ? "lock" : "greeter";
+    qCDebug(DDE_SHELL) << "configField:" << configField;
+    if (!enabledObj.contains(configField)) {
+        configField = "all";
+        if (!enabledObj.contains(configField)) {
+            qCWarning(DDE_SHELL) << "Do not exist valid field, can not get plugin enabled state.";
+            return probe;
+        }
+    }
+    const auto &detailObj = enabledObj.value(configField).toObject();
+    if (detailObj.contains("dconfig")) {
+        // 通过 dconfig 检查插件是否可以加载
+        const auto &dconfigObj = detailObj.value("dconfig").toObject();
+        probe.appId = dconfigObj.value("appid").toString();
+        probe.resource = dconfigObj.value("resource").toString();
+        probe.subpath = dconfigObj.value("subpath").toString();
+        probe.key = dconfigObj.value("key").toString();
+        qCInfo(DDE_SHELL) << "Check load state appid:" << probe.appId << ", resource:" << probe.resource << ", subpath:" << probe.subpath << ", key:" << probe.key;
+        if (probe.appId.isEmpty() || probe.resource.isEmpty() || probe.key.isEmpty()) {
             qCWarning(DDE_SHELL) << "Check load state is not valid.";
-            return false;
+            return probe;
         }
-        qCDebug(DDE_SHELL) << "Plugin enabled object:" << enabledObj;
-        const auto appType = qApp->property("dssAppType").toInt();
-        QString configField = appType == APP_TYPE_LOCK ? "lock" : "greeter";
-        qCDebug(DDE_SHELL) << "configField:" << configField;
-        if (!enabledObj.contains(configField)) {
-            configField = "all";
-            if (!enabledObj.contains(configField)) {
-                qCWarning(DDE_SHELL) << "Do not exist valid field, can not get plugin enabled state.";
-                return false;
-            }
+        probe.type = EnableProbe::DConfig;
+    } else if (detailObj.contains("dbusProperty")) {
+        // 通过 dbusProperty 检查插件是否可以加载
+        const auto &dbusPropertyObj = detailObj.value("dbusProperty").toObject();
+        probe.service = dbusPropertyObj.value("service").toString();
+        probe.path = dbusPropertyObj.value("path").toString();
+        probe.interface = dbusPropertyObj.value("interface").toString();
+        probe.property = dbusPropertyObj.value("property").toString();
+        probe.systemBus = dbusPropertyObj.value("dbusConnection").toString() == "systembus";
+        qCInfo(DDE_SHELL) << "Check plugin enabled service:" << probe.service << ", path:" << probe.path << ", interface:" << probe.interface << ", property:" << probe.property;
+        if (probe.service.isEmpty() || probe.path.isEmpty() || probe.interface.isEmpty() || probe.property.isEmpty()) {
+            qCWarning(DDE_SHELL) << "Check plugin enabled service is not valid.";
+            return probe;
         }
-        const auto &detailObj = enabledObj.value(configField).toObject();
-        if (detailObj.contains("dconfig")) {
-            // 通过 dconfig 检查插件是否可以加载
-            const auto &dconfigObj = detailObj.value("dconfig").toObject();
-            const auto& appid = dconfigObj.value("appid").toString();
-            const auto& resource = dconfigObj.value("resource").toString();
-            const auto& subpath = dconfigObj.value("subpath").toString();
-            const auto& key = dconfigObj.value("key").toString();
-            qCInfo(DDE_SHELL) << "Check load state appid:" << appid << ", resource:" << resource << ", subpath:" << subpath << ", key:" << key;
-            if (appid.isEmpty() || resource.isEmpty() || key.isEmpty()) {
-                qCWarning(DDE_SHELL) << "Check load state is not valid.";
-                return false;
-            }
-            if (appType == APP_TYPE_LOCK) {
-                DConfigHelper::instance()->bind(appid, resource, subpath, this, key, &ModulesLoader::onDConfigPropertyChanged);
-            }
-            const bool pluginEnabled = DConfigHelper::instance()->getConfig(appid, resource, subpath, key, true).toBool();
-            qCInfo(DDE_SHELL) << "Plugin is enabled:" << pluginEnabled;
-            return pluginEnabled;
-        } else if (detailObj.contains("dbusProperty")){
-            // 通过 dbusProperty 检查插件是否可以加载
-            const auto &dbusPropertyObj = detailObj.value("dbusProperty").toObject();
-            const auto& service = dbusPropertyObj.value("service").toString();
-            const auto& path = dbusPropertyObj.value("path").toString();
-            const auto& interface = dbusPropertyObj.value("interface").toString();
-            const auto& property = dbusPropertyObj.value("property").toString();
-            qCInfo(DDE_SHELL) << "Check plugin enabled service:" << service << ", path:" << path << ", interface:" << interface << ", property:" << property;
-            if (service.isEmpty() || path.isEmpty() || interface.isEmpty() || property.isEmpty()) {
-                qCWarning(DDE_SHELL) << "Check plugin enabled service is not valid.";
-                return false;
-            }
-            QString targetPath = path;
 
-            // 目前仅在 lock 中需要做这个处理
-            if (targetPath.contains("%{uid}") && appType == APP_TYPE_LOCK) {
-                targetPath = targetPath.replace("%{uid}", QString::number(static_cast<int>(getuid())));
-                qCInfo(DDE_SHELL) << "Check plugin enabled targetPath:" << targetPath;
-            }
-            auto dbusConnection = dbusPropertyObj.value("dbusConnection").toString() == "systembus" ? QDBusConnection::systemBus() : QDBusConnection::sessionBus();
-            auto dbusInterface = new QDBusInterface(service, targetPath, interface, dbusConnection);
-            if (!dbusInterface || !dbusInterface->isValid()) {
-                qCWarning(DDE_SHELL) << "Check plugin enabled dbus interface is not valid.";
-                dbusInterface->deleteLater();
-                return false;
-            }
-            const bool pluginEnabled = dbusInterface->property(property.toStdString().c_str()).toBool();
-            dbusInterface->deleteLater();
-            qCInfo(DDE_SHELL) << "Plugin is enabled:" << pluginEnabled;
-            // 监听属性变化
+        // 目前仅在 lock 中需要做这个处理
+        if (probe.path.contains("%{uid}") && appType == APP_TYPE_LOCK) {
+            probe.path = probe.path.replace("%{uid}", QString::number(static_cast<int>(getuid())));
+            qCInfo(DDE_SHELL) << "Check plugin enabled targetPath:" << probe.path;
+        }
+        probe.timeout = detailObj.value("timeout").toInt(DBUS_PROBE_TIMEOUT);
+        probe.type = EnableProbe::DBusProperty;
+    } else if (detailObj.contains("shell")) {
+        probe.command = detailObj.value("shell").toString();
+        qCInfo(DDE_SHELL) << "Check plugin enabled shell:" << probe.command;
+        if (probe.command.isEmpty()) {
+            qCWarning(DDE_SHELL) << "Check plugin enabled shell is empty";
+            return probe;
+        }
+        probe.timeout = detailObj.value("timeout").toInt(SHELL_PROBE_TIMEOUT);
+        probe.type = EnableProbe::Shell;
+    } else {
+        // 没有可用的判断条件时和之前一样加载插件
+        probe.type = EnableProbe::Always;
+    }
+
+    return probe;
+}
+
+/**
+ * @brief 同时执行所有插件的判断条件
+ *
+ * D-Bus 属性使用异步调用，shell 命令同时启动，之后再逐个等待结果，每个条件有自己的超时时间，
+ * 一个很慢的条件只影响它自己的插件。
+ *
+ * @param probes 插件路径 -> 判断条件
+ * @return 插件路径 -> 是否加载
+ */
+QHash<QString, bool> ModulesLoader::runEnableProbes(const QMap<QString, EnableProbe> &probes)
+{
+    QHash<QString, bool> enabledStates;
+    QHash<QString, QDBusPendingCall> dbusCalls;
+    QHash<QString, QProcess *> processes;
+    const auto appType = qApp->property("dssAppType").toInt();
+    QElapsedTimer timer;
+    timer.start();
+
+    for (auto it = probes.constBegin(); it != probes.constEnd(); ++it) {
+        const EnableProbe &probe = it.value();
+        switch (probe.type) {
+        case EnableProbe::Always:
+            enabledStates.insert(it.key(), true);
+            break;
+        case EnableProbe::Never:
+            enabledStates.insert(it.key(), false);
+            break;
+        case EnableProbe::DConfig: {
             if (appType == APP_TYPE_LOCK) {
-                dbusConnection.connect(
-                    service,
-                    targetPath,
-                    "org.freedesktop.DBus.Properties",
-                    "PropertiesChanged",
-                    this,
-                    SLOT(onDbusPropertiesChanged(QString, QVariantMap, QStringList)));
-                m_dbusInfo.insert(interface, property);
-            }
-            return pluginEnabled;
-
-        } else if (detailObj.contains("shell")) {
-            const auto &cmd = detailObj.value("shell").toString();
-            qCInfo(DDE_SHELL) << "Check plugin enabled shell:" << cmd;
-            if (cmd.isEmpty()) {
-                qCWarning(DDE_SHELL) << "Check plugin enabled shell is empty";
-                return false;
+                DConfigHelper::instance()->bind(probe.appId, probe.resource, probe.subpath, this, probe.key, &ModulesLoader::onDConfigPropertyChanged);
+                QMutexLocker locker(&m_mutex);
+                if (!m_dconfigDependents.contains(probe.key, it.key()))
+                    m_dconfigDependents.insert(probe.key, it.key());
             }
-            QProcess process;
-            process.start(cmd);
-            if (!process.waitForFinished()) {
-                qCWarning(DDE_SHELL) << "Execute shell timeout";
-                return false;
+            const bool pluginEnabled = DConfigHelper::instance()->getConfig(probe.appId, probe.resource, probe.subpath, probe.key, true).toBool();
+            qCInfo(DDE_SHELL) << "Plugin is enabled:" << pluginEnabled << ", path:" << it.key();
+            enabledStates.insert(it.key(), pluginEnabled);
+            break;
+        }
+        case EnableProbe::DBusProperty: {
+            auto dbusConnection = probe.systemBus ? QDBusConnection::systemBus() : QDBusConnection::sessionBus();
+            QDBusMessage message = QDBusMessage::createMethodCall(probe.service, probe.path, "org.freedesktop.DBus.Properties", "Get");
+            message << probe.interface << probe.property;
+            dbusCalls.insert(it.key(), dbusConnection.asyncCall(message, probe.timeout));
+            // 监听属性变化，同一个对象只连接一次
+            if (appType == APP_TYPE_LOCK) {
+                const QString dependency = probe.interface + "/" + probe.property;
+                QMutexLocker locker(&m_mutex);
+                if (!m_dbusDependents.contains(dependency, it.key())) {
+                    m_dbusDependents.insert(dependency, it.key());
+                    dbusConnection.connect(
+                        probe.service,
+                        probe.path,
+                        "org.freedesktop.DBus.Properties",
+                        "PropertiesChanged",
+                        this,
+                        SLOT(onDbusPropertiesChanged(QString, QVariantMap, QStringList)));
+                }
             }
-            const int exitCode = process.exitCode();
-            qCInfo(DDE_SHELL) << "Execute shell ret:" << exitCode;
-            return exitCode == 0;
+            break;
+        }
+        case EnableProbe::Shell: {
+            QProcess *process = new QProcess;
+            process->start(probe.command);
+            processes.insert(it.key(), process);
+            break;
+        }
+        }
+    }
+
+    for (auto it = dbusCalls.begin(); it != dbusCalls.end(); ++it) {
+        QDBusPendingReply<QDBusVariant> reply = it.value();
+        reply.waitForFinished();
+        if (reply.isError()) {
+            qCWarning(DDE_SHELL) << "Check plugin enabled dbus property failed, path:" << it.key() << ", error:" << reply.error().message();
+            enabledStates.insert(it.key(), false);
+            continue;
         }
+        const bool pluginEnabled = reply.value().variant().toBool();
+        qCInfo(DDE_SHELL) << "Plugin is enabled:" << pluginEnabled << ", path:" << it.key();
+        enabledStates.insert(it.key(), pluginEnabled);
     }
-    return true;
+
+    for (auto it = processes.begin(); it != processes.end(); ++it) {
+        QProcess *process = it.value();
+        // 所有命令同时启动，超时时间从启动时开始计算
+        const int remaining = qMax(0, probes.value(it.key()).timeout - static_cast<int>(timer.elapsed()));
+        if (!process->waitForFinished(remaining)) {
+            qCWarning(DDE_SHELL) << "Execute shell timeout, path:" << it.key();
+            process->kill();
+            process->waitForFinished(100);
+            enabledStates.insert(it.key(), false);
+        } else {
+            const int exitCode = process->exitCode();
+            qCInfo(DDE_SHELL) << "Execute shell ret:" << exitCode << ", path:" << it.key();
+            enabledStates.insert(it.key(), exitCode == 0);
+        }
+        delete process;
+    }
+
+    qCInfo(DDE_SHELL) << "Check plugin enabled finished, dbus probe count:" << dbusCalls.size()
+                      << ", shell probe count:" << processes.size() << ", elapsed:" << timer.elapsed() << "ms";
+    return enabledStates;
 }
 
 bool ModulesLoader::contains(const QString& pluginFile) const
@@ -362,7 +527,73 @@ void ModulesLoader::cleanupPluginLoader(QPluginLoader* loader)
     }
 }
 
-// TODO 只重新加载/卸载变更的插件
+/**
+ * @brief 重新判断插件是否需要加载
+ *
+ * @param paths 插件路径
+ */
+void ModulesLoader::requestReload(const QStringList &paths)
+{
+    if (paths.isEmpty())
+        return;
+
+    qCInfo(DDE_SHELL) << "Request reload plugins:" << paths;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (const QString &path : paths) {
+            m_pendingModules.insert(path);
+        }
+    }
+    // 正在加载时在 finished 中重新启动
+    if (!isRunning())
+        start(QThread::LowestPriority);
+}
+
+bool ModulesLoader::isParked(const QString &pluginFile) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_parkedPlugins.contains(pluginFile);
+}
+
+/**
+ * @brief 插件被禁用，从插件管理中移除，但不卸载库
+ */
+void ModulesLoader::parkPlugin(const QString &path)
+{
+    auto pair = getPluginLoader(path);
+    if (pair.first.isEmpty() || !pair.second)
+        return;
+
+    qCInfo(DDE_SHELL) << "Disable plugin: " << pair.first;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_parkedPlugins.insert(path, pair.first);
+    }
+    PluginManager::instance()->removePlugin(pair.first);
+}
+
+/**
+ * @brief 插件重新被启用，使用已经加载的库
+ */
+void ModulesLoader::restorePlugin(const QString &path, const QString &version, bool threadSafe)
+{
+    auto pair = getPluginLoader(path);
+    {
+        QMutexLocker locker(&m_mutex);
+        m_parkedPlugins.remove(path);
+    }
+    if (pair.first.isEmpty() || !pair.second)
+        return;
+
+    auto *moduleInstance = dynamic_cast<dss::module::BaseModuleInterface *>(pair.second->instance());
+    if (!moduleInstance || PluginManager::instance()->contains(pair.first))
+        return;
+
+    qCInfo(DDE_SHELL) << "Enable plugin: " << pair.first;
+    PluginManager::instance()->addPlugin(moduleInstance, version, threadSafe);
+    Q_EMIT loadPluginsFinished();
+}
+
 void ModulesLoader::onDConfigPropertyChanged(const QString& key, const QVariant& value, QObject* objPtr)
 {
     auto obj = qobject_cast<ModulesLoader*>(objPtr);
@@ -370,17 +601,27 @@ void ModulesLoader::onDConfigPropertyChanged(const QString& key, const QVariant&
         return;
 
     qCInfo(DDE_SHELL) << "DConfig property changed, key: " << key << ", value: " << value;
-    obj->start(QThread::LowestPriority);
+    QStringList paths;
+    {
+        QMutexLocker locker(&obj->m_mutex);
+        paths = obj->m_dconfigDependents.values(key);
+    }
+    obj->requestReload(paths);
 }
 
 void ModulesLoader::onDbusPropertiesChanged(const QString& interfaceName, const QVariantMap& changedProperties, const QStringList& invalidatedProperties)
 {
     Q_UNUSED(invalidatedProperties)
     qCDebug(DDE_SHELL) << "Dbus properties changed, interface: " << interfaceName << ", changed properties: " << changedProperties;
-    if (m_dbusInfo.contains(interfaceName)) {
-        const auto &property = m_dbusInfo.value(interfaceName);
-        if (changedProperties.contains(property)) {
-            start(QThread::LowestPriority);
+    QStringList paths;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (auto it = changedProperties.constBegin(); it != changedProperties.constEnd(); ++it) {
+            for (const QString &path : m_dbusDependents.values(interfaceName + "/" + it.key())) {
+                if (!paths.contains(path))
+                    paths.append(path);
+            }
         }
     }
+    requestReload(paths);
 }
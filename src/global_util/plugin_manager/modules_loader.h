@@ -6,8 +6,10 @@
 #define MODULES_LOADER_H
 
 #include "sessionbasemodel.h"
+#include "plugin_meta_index.h"
 
 #include <QHash>
+#include <QSet>
 #include <QThread>
 #include <QSharedPointer>
 #include <QFileInfo>
@@ -36,8 +38,40 @@ private:
     ModulesLoader(const ModulesLoader &) = delete;
     ModulesLoader &operator=(const ModulesLoader &) = delete;
 
-    void findModule(const QString &path);
-    bool isPluginEnabled(const QFileInfo &module);
+    /**
+     * @brief 插件是否加载的判断条件，来自 config.d 中和插件同名的 json 文件
+     */
+    struct EnableProbe {
+        enum Type {
+            Always,       // 没有配置，直接加载
+            Never,        // 配置无效，不加载
+            DConfig,
+            DBusProperty,
+            Shell
+        };
+
+        Type type = Always;
+        // dconfig
+        QString appId;
+        QString resource;
+        QString subpath;
+        QString key;
+        // dbusProperty
+        QString service;
+        QString path;
+        QString interface;
+        QString property;
+        bool systemBus = false;
+        // shell
+        QString command;
+        int timeout = 0; // 毫秒
+    };
+
+    void findModule(const QString &path, const QSet<QString> &targets = QSet<QString>());
+    void requestReload(const QStringList &paths);
+    bool isParked(const QString &pluginFile) const;
+    EnableProbe readEnableProbe(const QFileInfo &module) const;
+    QHash<QString, bool> runEnableProbes(const QMap<QString, EnableProbe> &probes);
     bool contains(const QString &pluginFile) const;
     QPair<QString, QPluginLoader*> getPluginLoader(const QString &pluginFile) const;
     void cleanupPluginLoader(QPluginLoader* loader);
@@ -46,6 +80,8 @@ private:
 
 private Q_SLOTS:
     void unloadPlugin(const QString &path);
+    void parkPlugin(const QString &path);
+    void restorePlugin(const QString &path, const QString &version, bool threadSafe);
     void onDbusPropertiesChanged(const QString& interfaceName,
         const QVariantMap& changedProperties,
         const QStringList& invalidatedProperties);
@@ -53,9 +89,14 @@ private Q_SLOTS:
 private:
     bool m_loadLoginModule;
     QMap<QString, QPointer<QPluginLoader>> m_pluginLoaders;
-    QMap<QString, QString> m_dbusInfo;
     mutable QMutex m_mutex;
+    // 配置或属性变化时只重新判断依赖它的插件
+    QMultiHash<QString, QString> m_dconfigDependents; // dconfig 键 -> 插件路径
+    QMultiHash<QString, QString> m_dbusDependents;    // "接口/属性" -> 插件路径
+    QSet<QString> m_pendingModules;                   // 等待重新判断的插件路径
+    QHash<QString, QString> m_parkedPlugins;          // 被禁用但没有卸载的插件路径 -> 插件 key
     QPointer<SessionBaseModel> m_model;
+    PluginMetaIndex m_metaIndex;
 };
 
 #endif // MODULES_LOADER_H
@@ -7,6 +7,7 @@
 PluginBase::PluginBase(dss::module::BaseModuleInterface* module, QObject *parent)
     : QObject(parent)
     , m_plugin(module)
+    , m_threadSafe(false)
 {
 
 }
@@ -40,12 +40,21 @@ public:
 
     virtual QString message(const QString &) { return ""; }
 
+    /**
+     * @brief 插件在元数据中声明了 "threadSafe": true，通知可以在非主线程中发送
+     */
+    inline bool isThreadSafe() const { return m_threadSafe; }
+    inline void setThreadSafe(bool threadSafe) { m_threadSafe = threadSafe; }
+
     static QJsonObject getRootObj(const QString &jsonStr);
 
     static QJsonObject getDataObj(const QString &jsonStr);
 
 protected:
     dss::module::BaseModuleInterface *m_plugin;
+
+private:
+    bool m_threadSafe;
 };
 
 #endif // PLUGIN_BASE_H
@@ -0,0 +1,350 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "plugin_dispatcher.h"
+#include "constants.h"
+#include "dconfig_helper.h"
+#include "login_plugin.h"
+
+#include <QApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QThread>
+#include <QWaitCondition>
+
+static const QString PLUGIN_CALL_BUDGET = "pluginCallBudget";
+static const int DEFAULT_BUDGET = 50;
+// 连续超过预算的次数达到后降级
+static const int DEMOTE_THRESHOLD = 3;
+// 降级后连续在预算内返回的次数达到后恢复
+static const int RESTORE_THRESHOLD = 10;
+// 这些通知只反映最新的状态，插件被降级后暂不发送，同类只保留最新的一条，在插件下一次收到其它消息前补发
+static const QStringList COALESCED_COMMANDS = {"CurrentUserChanged", "AuthFactorsChanged", "LimitsInfo"};
+
+Q_GLOBAL_STATIC(PluginDispatcher, pluginDispatcher)
+
+/**
+ * @brief 给线程安全的插件按顺序发送通知
+ */
+class PluginDispatchThread : public QThread
+{
+public:
+    struct Job {
+        LoginPlugin *plugin;
+        QString key;
+        QVariantMap message;
+    };
+
+    explicit PluginDispatchThread(PluginDispatcher *dispatcher)
+        : m_dispatcher(dispatcher)
+        , m_stopped(false)
+    {
+    }
+
+    void enqueue(const Job &job)
+    {
+        QMutexLocker locker(&m_mutex);
+        m_jobs.append(job);
+        m_jobAdded.wakeOne();
+    }
+
+    /**
+     * @brief 等待插件之前的通知处理完成，保证同步调用在这些通知之后
+     *
+     * @param timeout 最多等待的毫秒数
+     * @return false 超时，之前的通知还没有处理完
+     */
+    bool flush(const QString &key, int timeout)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        QMutexLocker locker(&m_mutex);
+        while (m_runningKey == key || hasJob(key)) {
+            const qint64 remaining = timeout - timer.elapsed();
+            if (remaining <= 0 || !m_jobFinished.wait(&m_mutex, static_cast<unsigned long>(remaining)))
+                return !(m_runningKey == key || hasJob(key));
+        }
+        return true;
+    }
+
+    /**
+     * @brief 丢弃插件还没有发送的通知，插件正在处理通知时等待处理完成
+     */
+    void forget(const QString &key)
+    {
+        QMutexLocker locker(&m_mutex);
+        for (auto it = m_jobs.begin(); it != m_jobs.end();) {
+            if (it->key == key) {
+                it = m_jobs.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        while (m_runningKey == key) {
+            m_jobFinished.wait(&m_mutex);
+        }
+    }
+
+    void stop()
+    {
+        {
+            QMutexLocker locker(&m_mutex);
+            m_stopped = true;
+            m_jobs.clear();
+            m_jobAdded.wakeOne();
+        }
+        wait();
+    }
+
+protected:
+    void run() override
+    {
+        QMutexLocker locker(&m_mutex);
+        while (!m_stopped) {
+            if (m_jobs.isEmpty()) {
+                m_jobAdded.wait(&m_mutex);
+                continue;
+            }
+
+            const Job job = m_jobs.takeFirst();
+            m_runningKey = job.key;
+            locker.unlock();
+            m_dispatcher->invoke(job.plugin, job.key, job.message);
+            locker.relock();
+            m_runningKey.clear();
+            m_jobFinished.wakeAll();
+        }
+    }
+
+private:
+    bool hasJob(const QString &key) const
+    {
+        for (const Job &job : m_jobs) {
+            if (job.key == key)
+                return true;
+        }
+        return false;
+    }
+
+private:
+    PluginDispatcher *m_dispatcher;
+    QMutex m_mutex;
+    QWaitCondition m_jobAdded;
+    QWaitCondition m_jobFinished;
+    QList<Job> m_jobs;
+    QString m_runningKey;
+    bool m_stopped;
+};
+
+PluginDispatcher::PluginDispatcher(QObject *parent)
+    : QObject(parent)
+    , m_budget(DEFAULT_BUDGET)
+    , m_thread(nullptr)
+{
+    moveToThread(qApp->thread());
+
+    DConfigHelper::instance()->bind(this, PLUGIN_CALL_BUDGET, &PluginDispatcher::onDConfigPropertyChanged);
+    setBudget(DConfigHelper::instance()->getConfig(PLUGIN_CALL_BUDGET, DEFAULT_BUDGET).toInt());
+}
+
+PluginDispatcher::~PluginDispatcher()
+{
+    if (m_thread) {
+        m_thread->stop();
+        delete m_thread;
+    }
+}
+
+PluginDispatcher *PluginDispatcher::instance()
+{
+    return pluginDispatcher;
+}
+
+/**
+ * @brief 同步调用插件并记录耗时，需要插件返回结果时使用
+ *
+ * 线程安全的插件先等待之前的通知处理完成，最多等待一次调用的预算时间，超时后不再等待，
+ * 此时插件收到消息的顺序可能和发送的顺序不一致；其它插件先补发降级期间暂存的状态通知。
+ */
+QVariantMap PluginDispatcher::call(LoginPlugin *plugin, const QVariantMap &message)
+{
+    if (!plugin)
+        return QVariantMap();
+
+    const QString key = plugin->key();
+    if (plugin->isThreadSafe()) {
+        if (m_thread && !m_thread->flush(key, budget())) {
+            qCWarning(DDE_SHELL) << "Plugin is still handling notifications, call it without waiting, key:" << key
+                                 << ", cmd type:" << message.value("CmdType").toString();
+        }
+    } else {
+        deliverPending(plugin, key);
+    }
+
+    return invoke(plugin, key, message);
+}
+
+/**
+ * @brief 给插件发送通知，不需要插件返回结果
+ *
+ * 线程安全的插件在通知线程中处理；被降级的插件暂存只反映最新状态的通知，同类只保留最新的一条，
+ * 在插件下一次收到其它消息前按顺序补发；认证状态等其它通知和其它插件仍然在界面线程中直接调用。
+ */
+void PluginDispatcher::notify(LoginPlugin *plugin, const QVariantMap &message)
+{
+    if (!plugin)
+        return;
+
+    const QString key = plugin->key();
+    if (plugin->isThreadSafe()) {
+        if (!m_thread) {
+            m_thread = new PluginDispatchThread(this);
+            m_thread->start();
+        }
+        m_thread->enqueue({plugin, key, message});
+        return;
+    }
+
+    const QString cmdType = message.value("CmdType").toString();
+    if (COALESCED_COMMANDS.contains(cmdType) && isDemoted(key)) {
+        QList<QVariantMap> &messages = m_pendingMessages[key];
+        for (auto it = messages.begin(); it != messages.end();) {
+            if (it->value("CmdType").toString() == cmdType) {
+                it = messages.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        messages.append(message);
+        qCDebug(DDE_SHELL) << "Plugin is demoted, hold notification, key:" << key << ", cmd type:" << cmdType;
+        return;
+    }
+
+    deliverPending(plugin, key);
+    invoke(plugin, key, message);
+}
+
+/**
+ * @brief 插件暂存的状态通知个数
+ */
+int PluginDispatcher::pendingCount(const QString &key) const
+{
+    return m_pendingMessages.value(key).size();
+}
+
+/**
+ * @brief 插件被移除前调用，丢弃还没有发送的通知和耗时统计
+ */
+void PluginDispatcher::forget(const QString &key)
+{
+    if (m_thread)
+        m_thread->forget(key);
+
+    m_pendingMessages.remove(key);
+
+    QMutexLocker locker(&m_mutex);
+    m_stats.remove(key);
+}
+
+PluginDispatcher::Stats PluginDispatcher::stats(const QString &key) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_stats.value(key);
+}
+
+bool PluginDispatcher::isDemoted(const QString &key) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_stats.constFind(key);
+    return it != m_stats.constEnd() && it->demoted;
+}
+
+void PluginDispatcher::setBudget(int budget)
+{
+    QMutexLocker locker(&m_mutex);
+    m_budget = budget > 0 ? budget : DEFAULT_BUDGET;
+}
+
+int PluginDispatcher::budget() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_budget;
+}
+
+void PluginDispatcher::onDConfigPropertyChanged(const QString &key, const QVariant &value, QObject *objPtr)
+{
+    auto obj = qobject_cast<PluginDispatcher *>(objPtr);
+    if (!obj || key != PLUGIN_CALL_BUDGET)
+        return;
+
+    obj->setBudget(value.toInt());
+}
+
+QVariantMap PluginDispatcher::invoke(LoginPlugin *plugin, const QString &key, const QVariantMap &message)
+{
+    QElapsedTimer timer;
+    timer.start();
+    const QVariantMap &result = plugin->message(message);
+    record(key, message.value("CmdType").toString(), timer.nsecsElapsed() / 1000);
+    return result;
+}
+
+void PluginDispatcher::record(const QString &key, const QString &cmdType, qint64 elapsed)
+{
+    bool demoted = false;
+    qint64 averageTime = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+        Stats &stats = m_stats[key];
+        ++stats.calls;
+        stats.totalTime += elapsed;
+        stats.maxTime = qMax(stats.maxTime, elapsed);
+
+        if (elapsed > static_cast<qint64>(m_budget) * 1000) {
+            ++stats.slowCalls;
+            ++stats.consecutiveSlow;
+            stats.consecutiveFast = 0;
+            qCWarning(DDE_SHELL) << "Plugin call is too slow, key:" << key << ", cmd type:" << cmdType
+                                 << ", elapsed:" << elapsed / 1000 << "ms, budget:" << m_budget << "ms";
+            if (!stats.demoted && stats.consecutiveSlow >= DEMOTE_THRESHOLD) {
+                stats.demoted = true;
+                demoted = true;
+                averageTime = stats.averageTime();
+            }
+        } else {
+            ++stats.consecutiveFast;
+            stats.consecutiveSlow = 0;
+            if (stats.demoted && stats.consecutiveFast >= RESTORE_THRESHOLD) {
+                stats.demoted = false;
+                qCInfo(DDE_SHELL) << "Plugin is fast again, restore it, key:" << key;
+            }
+        }
+    }
+
+    if (demoted) {
+        qCWarning(DDE_SHELL) << "Plugin exceeds the call budget repeatedly, demote it, key:" << key
+                             << ", average:" << averageTime / 1000 << "ms";
+        // 线程安全的插件在通知线程中被降级，信号统一在界面线程中发出
+        if (QThread::currentThread() == thread()) {
+            Q_EMIT pluginDemoted(key, averageTime);
+        } else {
+            QMetaObject::invokeMethod(this, "pluginDemoted", Qt::QueuedConnection, Q_ARG(QString, key), Q_ARG(qint64, averageTime));
+        }
+    }
+}
+
+/**
+ * @brief 在插件收到其它消息前补发暂存的状态通知，只在界面线程中调用
+ */
+void PluginDispatcher::deliverPending(LoginPlugin *plugin, const QString &key)
+{
+    if (!m_pendingMessages.contains(key))
+        return;
+
+    const QList<QVariantMap> messages = m_pendingMessages.take(key);
+    for (const QVariantMap &message : messages) {
+        invoke(plugin, key, message);
+    }
+}
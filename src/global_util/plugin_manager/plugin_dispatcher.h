@@ -0,0 +1,81 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PLUGIN_DISPATCHER_H
+#define PLUGIN_DISPATCHER_H
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QVariantMap>
+
+class LoginPlugin;
+class PluginDispatchThread;
+
+/**
+ * @brief 登录器调用登录插件的统一入口
+ *
+ * 记录每个插件每次调用的耗时，超过预算的调用会打印警告。连续多次超过预算的插件被降级，
+ * 降级后只反映最新状态的通知（CurrentUserChanged、AuthFactorsChanged、LimitsInfo）暂存起来，
+ * 同类只保留最新的一条，在插件下一次收到其它消息前按顺序补发，减少界面线程被阻塞的次数；
+ * 认证状态等其它通知和同步调用仍然在界面线程中直接调用，降级不会把它们移出界面线程。
+ * 降级的插件连续多次在预算内返回后恢复。
+ * 在元数据中声明了 "threadSafe": true 的插件，通知在单独的线程中按顺序发送，不占用界面线程；
+ * 同步调用前最多等待一次调用的预算时间，让之前的通知先处理完。
+ * pluginDemoted 信号总是在界面线程中发出。
+ */
+class PluginDispatcher : public QObject
+{
+    Q_OBJECT
+public:
+    struct Stats {
+        quint64 calls = 0;       // 调用次数
+        quint64 slowCalls = 0;   // 超过预算的次数
+        qint64 totalTime = 0;    // 总耗时（微秒）
+        qint64 maxTime = 0;      // 最长耗时（微秒）
+        int consecutiveSlow = 0;
+        int consecutiveFast = 0;
+        bool demoted = false;
+
+        inline qint64 averageTime() const { return calls > 0 ? totalTime / static_cast<qint64>(calls) : 0; }
+    };
+
+    explicit PluginDispatcher(QObject *parent = nullptr);
+    ~PluginDispatcher() override;
+
+    static PluginDispatcher *instance();
+
+    QVariantMap call(LoginPlugin *plugin, const QVariantMap &message);
+    void notify(LoginPlugin *plugin, const QVariantMap &message);
+    void forget(const QString &key);
+    int pendingCount(const QString &key) const;
+
+    Stats stats(const QString &key) const;
+    bool isDemoted(const QString &key) const;
+
+    void setBudget(int budget);
+    int budget() const;
+
+Q_SIGNALS:
+    void pluginDemoted(const QString &key, qint64 averageTime);
+
+private:
+    static void onDConfigPropertyChanged(const QString &key, const QVariant &value, QObject *objPtr);
+    QVariantMap invoke(LoginPlugin *plugin, const QString &key, const QVariantMap &message);
+    void record(const QString &key, const QString &cmdType, qint64 elapsed);
+    void deliverPending(LoginPlugin *plugin, const QString &key);
+
+    friend class PluginDispatchThread;
+
+private:
+    mutable QMutex m_mutex;
+    QHash<QString, Stats> m_stats;
+    int m_budget; // 毫秒，受 m_mutex 保护
+    PluginDispatchThread *m_thread;
+    // 被降级的插件暂存的状态通知，只在界面线程中使用
+    QHash<QString, QList<QVariantMap>> m_pendingMessages;
+};
+
+#endif // PLUGIN_DISPATCHER_H
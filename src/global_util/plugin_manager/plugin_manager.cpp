@@ -7,8 +7,10 @@
 #include "dconfig_helper.h"
 #include "login_plugin_v1.h"
 #include "login_plugin_v2.h"
+#include "login_plugin_v3.h"
 #include "public_func.h"
 #include "modules_loader.h"
+#include "plugin_dispatcher.h"
 
 static PluginManager pluginManager;
 
@@ -25,7 +27,7 @@ PluginManager* PluginManager::instance()
     return &pluginManager;
 }
 
-void PluginManager::addPlugin(dss::module::BaseModuleInterface* module, const QString& version)
+void PluginManager::addPlugin(dss::module::BaseModuleInterface* module, const QString& version, bool threadSafe)
 {
     if (!module) {
         qCWarning(DDE_SHELL) << "Module is null.";
@@ -39,6 +41,7 @@ void PluginManager::addPlugin(dss::module::BaseModuleInterface* module, const QS
         return;
     }
 
+    plugin->setThreadSafe(threadSafe);
     const QString& key = plugin->key();
     m_plugins.insert(key, plugin);
     connect(plugin, &QObject::destroyed, this, [this, key] {
@@ -56,6 +59,8 @@ void PluginManager::removePlugin(const QString &key)
         return;
     }
     Q_EMIT pluginAboutToBeRemoved(key);
+    // 丢弃还没有发送给插件的通知，插件正在处理通知时等待处理完成
+    PluginDispatcher::instance()->forget(key);
     if (it.value())
         it.value()->deleteLater();
     m_plugins.remove(key);
@@ -154,6 +159,16 @@ PluginBase* PluginManager::createPlugin(dss::module::BaseModuleInterface* module
 LoginPlugin* PluginManager::createLoginPlugin(dss::module::BaseModuleInterface* module, const QString& version)
 {
     qCInfo(DDE_SHELL) << "Create login plugin, meta version: " << version;
+    if (checkVersion(version, LoginPlugin_V3::API_VERSION)) {
+        auto moduleV3 = dynamic_cast<dss::module_v3::LoginModuleInterfaceV3*>(module);
+        if (moduleV3) {
+            qCInfo(DDE_SHELL) << "Create LoginPluginV3";
+            return new LoginPlugin_V3::LoginPluginV3(moduleV3);
+        }
+        // 元数据中的版本和实现的接口不一致，按 2.0.0 的插件处理
+        qCWarning(DDE_SHELL) << "Plugin does not implement LoginModuleInterfaceV3, use LoginPluginV2";
+    }
+
     if (checkVersion(version, LoginPlugin_V2::API_VERSION)) {
         qCInfo(DDE_SHELL) << "Create LoginPluginV2";
         return new LoginPlugin_V2::LoginPluginV2(dynamic_cast<dss::module_v2::LoginModuleInterfaceV2*>(module));
@@ -22,7 +22,7 @@ public:
     static PluginManager* instance();
 
     void setModel(SessionBaseModel *model);
-    void addPlugin(dss::module::BaseModuleInterface *module, const QString &version);
+    void addPlugin(dss::module::BaseModuleInterface *module, const QString &version, bool threadSafe = false);
     void removePlugin(const QString &key);
     QList<LoginPlugin*> getLoginPlugins(int level = 1) const;
     LoginPlugin *getFullManagedLoginPlugin() const;
@@ -0,0 +1,153 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "plugin_meta_index.h"
+#include "constants.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+namespace {
+
+const quint32 INDEX_MAGIC = 0x44535350; // "DSSP"
+const quint32 INDEX_VERSION = 2;
+
+}
+
+PluginMetaIndex::PluginMetaIndex(const QString &cacheFile)
+    : m_cacheFile(cacheFile)
+    , m_dirty(false)
+{
+}
+
+QString PluginMetaIndex::defaultCacheFile()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/dde-session-shell/plugins/index.cache";
+}
+
+bool PluginMetaIndex::load()
+{
+    m_entries.clear();
+    m_dirty = false;
+
+    QFile file(m_cacheFile);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint32 count = 0;
+    stream >> magic >> version >> count;
+    if (stream.status() != QDataStream::Ok || magic != INDEX_MAGIC || version != INDEX_VERSION) {
+        qCWarning(DDE_SHELL) << "Invalid plugin index file:" << m_cacheFile;
+        return false;
+    }
+
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        QString path;
+        Entry entry;
+        stream >> path >> entry.modified >> entry.size >> entry.api >> entry.pluginType >> entry.key >> entry.threadSafe;
+        m_entries.insert(path, entry);
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        qCWarning(DDE_SHELL) << "Invalid plugin index file:" << m_cacheFile;
+        m_entries.clear();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief 保存索引，先写临时文件再重命名
+ */
+bool PluginMetaIndex::save()
+{
+    if (!QDir().mkpath(QFileInfo(m_cacheFile).absolutePath())) {
+        qCWarning(DDE_SHELL) << "Failed to create plugin index dir:" << m_cacheFile;
+        return false;
+    }
+
+    QSaveFile file(m_cacheFile);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(DDE_SHELL) << "Failed to open plugin index file:" << m_cacheFile;
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+    stream << INDEX_MAGIC << INDEX_VERSION << static_cast<quint32>(m_entries.size());
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        const Entry &entry = it.value();
+        stream << it.key() << entry.modified << entry.size << entry.api << entry.pluginType << entry.key << entry.threadSafe;
+    }
+
+    if (!file.commit()) {
+        qCWarning(DDE_SHELL) << "Failed to write plugin index file:" << m_cacheFile;
+        return false;
+    }
+
+    m_dirty = false;
+    return true;
+}
+
+/**
+ * @brief 查找插件的元数据，文件修改时间和大小都一致时才有效
+ */
+bool PluginMetaIndex::find(const QFileInfo &file, Entry &entry) const
+{
+    auto it = m_entries.constFind(file.absoluteFilePath());
+    if (it == m_entries.constEnd()
+            || it->modified != file.lastModified().toMSecsSinceEpoch()
+            || it->size != file.size()) {
+        return false;
+    }
+
+    entry = it.value();
+    return true;
+}
+
+void PluginMetaIndex::insert(const QFileInfo &file, const Entry &entry)
+{
+    Entry newEntry = entry;
+    newEntry.modified = file.lastModified().toMSecsSinceEpoch();
+    newEntry.size = file.size();
+    m_entries.insert(file.absoluteFilePath(), newEntry);
+    m_dirty = true;
+}
+
+void PluginMetaIndex::setKey(const QFileInfo &file, const QString &key)
+{
+    auto it = m_entries.find(file.absoluteFilePath());
+    if (it == m_entries.end() || it->key == key) {
+        return;
+    }
+
+    it->key = key;
+    m_dirty = true;
+}
+
+/**
+ * @brief 删除已经不存在的插件的记录
+ */
+void PluginMetaIndex::retain(const QSet<QString> &paths)
+{
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (!paths.contains(it.key())) {
+            it = m_entries.erase(it);
+            m_dirty = true;
+        } else {
+            ++it;
+        }
+    }
+}
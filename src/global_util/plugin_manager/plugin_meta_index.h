@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PLUGIN_META_INDEX_H
+#define PLUGIN_META_INDEX_H
+
+#include <QFileInfo>
+#include <QHash>
+#include <QSet>
+#include <QString>
+
+/**
+ * @brief 插件元数据的磁盘索引
+ *
+ * 按插件文件路径保存 api 版本、插件类型、是否线程安全和插件的 key，插件文件的修改时间或大小变化后对应的记录失效。
+ * 有记录时不需要读取插件文件中的元数据，版本过低、类型不匹配、在黑名单中或者已经加载的插件不会被 dlopen。
+ * 只在插件加载线程中使用。
+ */
+class PluginMetaIndex
+{
+public:
+    struct Entry {
+        qint64 modified = 0;
+        qint64 size = 0;
+        QString api;
+        QString pluginType;
+        QString key; // 插件第一次加载后才知道
+        bool threadSafe = false; // 插件声明可以在非主线程接收通知
+    };
+
+    explicit PluginMetaIndex(const QString &cacheFile = defaultCacheFile());
+
+    static QString defaultCacheFile();
+
+    bool load();
+    bool save();
+
+    bool find(const QFileInfo &file, Entry &entry) const;
+    void insert(const QFileInfo &file, const Entry &entry);
+    void setKey(const QFileInfo &file, const QString &key);
+    void retain(const QSet<QString> &paths);
+
+    inline bool isDirty() const { return m_dirty; }
+    inline int size() const { return m_entries.size(); }
+
+private:
+    QString m_cacheFile;
+    QHash<QString, Entry> m_entries;
+    bool m_dirty;
+};
+
+#endif // PLUGIN_META_INDEX_H
@@ -28,6 +28,8 @@
 #include <QDBusInterface>
 #endif
 
+#include <atomic>
+
 using namespace std;
 
 DCORE_USE_NAMESPACE
@@ -193,6 +195,56 @@ bool checkPictureCanRead(const QString &fileName)
     return reader.canRead();
 }
 
+#ifndef ENABLE_DSS_SNIPE
+namespace {
+
+/**
+ * @brief 域管认证开关，QGSettings 只创建一次，配置变化时更新缓存的值
+ *
+ * 每次 PAM 认证都会在认证线程中读取，所以保存为原子变量。
+ */
+class DeepinAuthControl
+{
+public:
+    DeepinAuthControl()
+        : m_settings(nullptr)
+        , m_useDeepinAuth(true)
+    {
+        const char *controlId = "com.deepin.dde.auth.control";
+        if (!QGSettings::isSchemaInstalled(controlId))
+            return;
+
+        const char *controlPath = "/com/deepin/dde/auth/control/";
+        m_settings = new QGSettings(controlId, controlPath);
+        m_settings->moveToThread(qApp->thread());
+        update();
+        QObject::connect(m_settings, &QGSettings::changed, m_settings, [this](const QString &key) {
+            if (key == "useDeepinAuth") {
+                update();
+            }
+        });
+    }
+
+    bool useDeepinAuth() const { return m_useDeepinAuth; }
+
+private:
+    void update()
+    {
+        const QString &key = "useDeepinAuth";
+        m_useDeepinAuth = m_settings->keys().contains(key) && m_settings->get(key).toBool();
+        qCDebug(DDE_SHELL) << "Use deepin auth: " << m_useDeepinAuth;
+    }
+
+private:
+    QGSettings *m_settings;
+    std::atomic<bool> m_useDeepinAuth;
+};
+
+}
+
+Q_GLOBAL_STATIC(DeepinAuthControl, deepinAuthControl)
+#endif
+
 /**
  * @brief 是否使用域管认证。
  *
@@ -202,21 +254,11 @@ bool checkPictureCanRead(const QString &fileName)
 bool isDeepinAuth()
 {
 #ifndef ENABLE_DSS_SNIPE
-    const char* controlId = "com.deepin.dde.auth.control";
-    if (QGSettings::isSchemaInstalled(controlId)) {
-        const char *controlPath = "/com/deepin/dde/auth/control/";
-        QGSettings controlObj(controlId, controlPath);
-        const QString &key = "useDeepinAuth";
-        bool useDeepinAuth = controlObj.keys().contains(key) && controlObj.get(key).toBool();
-    #ifdef QT_DEBUG
-        qDebug() << "Use deepin auth: " << useDeepinAuth;
-    #endif
-        return useDeepinAuth;
-    }
+    return deepinAuthControl->useDeepinAuth();
 #else
     // TODO this gsetting config provided by 域管
-#endif
     return true;
+#endif
 }
 
 uint timeFromString(QString time)
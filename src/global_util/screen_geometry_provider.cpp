@@ -0,0 +1,186 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "screen_geometry_provider.h"
+#include "constants.h"
+#include "dbusconstant.h"
+
+#include <QApplication>
+#include <QDBusPendingCallWatcher>
+#include <QDebug>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QScreen>
+#ifndef ENABLE_DSS_SNIPE
+#include <QX11Info>
+#endif
+
+#include <X11/Xlib.h>
+#include <X11/extensions/Xrandr.h>
+
+Q_GLOBAL_STATIC(ScreenGeometryProvider, screenGeometryProvider)
+
+ScreenGeometryProvider::ScreenGeometryProvider(QObject *parent)
+    : QObject(parent)
+    , m_systemDisplay(new SystemDisplayInter(DSS_DBUS::systemDisplayService, DSS_DBUS::systemDisplayPath, QDBusConnection::systemBus(), this))
+    , m_scaleFactorReady(false)
+    , m_scaleFactor(-1.0)
+    , m_dirty(true)
+{
+    moveToThread(qApp->thread());
+
+    connect(qApp, &QGuiApplication::screenAdded, this, [this](QScreen *screen) {
+        connect(screen, &QScreen::geometryChanged, this, &ScreenGeometryProvider::invalidate);
+        invalidate();
+    });
+    connect(qApp, &QGuiApplication::screenRemoved, this, &ScreenGeometryProvider::invalidate);
+    for (QScreen *screen : qApp->screens()) {
+        connect(screen, &QScreen::geometryChanged, this, &ScreenGeometryProvider::invalidate);
+    }
+
+    // 缩放比例只获取一次，之后跟随显示配置的变化更新
+    connect(m_systemDisplay, &SystemDisplayInter::ConfigUpdated, this, &ScreenGeometryProvider::onDisplayConfigUpdated);
+    auto *watcher = new QDBusPendingCallWatcher(m_systemDisplay->GetConfig(), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this](QDBusPendingCallWatcher *callWatcher) {
+        callWatcher->deleteLater();
+        QDBusPendingReply<QString> reply = *callWatcher;
+        if (reply.isError()) {
+            qCWarning(DDE_SHELL) << "Greeter get system display config failed:" << reply.error().message();
+        }
+        updateScaleFactor(reply.isError() ? -1.0 : scaleFactorFromConfig(reply.value()));
+    });
+}
+
+ScreenGeometryProvider *ScreenGeometryProvider::instance()
+{
+    return screenGeometryProvider;
+}
+
+/**
+ * @brief 是否已经获取到显示服务的缩放比例
+ */
+bool ScreenGeometryProvider::isReady() const
+{
+    return m_scaleFactorReady;
+}
+
+/**
+ * @brief 获取XRandR的屏幕几何信息，屏幕没有变化时直接返回缓存的结果
+ *
+ * @return 屏幕名称和位置尺寸，缩放比例获取失败或者和Qt的不一致时返回空，使用Qt的屏幕信息
+ */
+QMap<QString, QRect> ScreenGeometryProvider::geometries()
+{
+    // 窗口可能比本对象先收到屏幕变化的信号，所以还要比较Qt的屏幕布局
+    const QMap<QString, QRect> snapshot = qtScreenGeometries();
+    if (!m_dirty && m_snapshot == snapshot) {
+        return m_geometries;
+    }
+
+    const double qtScale = qApp->devicePixelRatio();
+    qCInfo(DDE_SHELL) << "Get scale factor from display scale:" << m_scaleFactor << " scale from display qt:" << qtScale;
+    // 如果获取失败或者与从Qt获取的不一致，则不需要处理，使用Qt的屏幕信息
+    m_geometries = (m_scaleFactor <= 0 || qtScale != m_scaleFactor) ? QMap<QString, QRect>() : queryGeometries(m_scaleFactor);
+    m_snapshot = snapshot;
+    m_dirty = false;
+
+    return m_geometries;
+}
+
+void ScreenGeometryProvider::onDisplayConfigUpdated(const QString &config)
+{
+    updateScaleFactor(scaleFactorFromConfig(config));
+}
+
+void ScreenGeometryProvider::invalidate()
+{
+    m_dirty = true;
+}
+
+void ScreenGeometryProvider::updateScaleFactor(double scaleFactor)
+{
+    if (m_scaleFactorReady && qFuzzyCompare(m_scaleFactor, scaleFactor)) {
+        return;
+    }
+
+    m_scaleFactor = scaleFactor;
+    m_scaleFactorReady = true;
+    m_dirty = true;
+    Q_EMIT geometriesUpdated();
+}
+
+QMap<QString, QRect> ScreenGeometryProvider::qtScreenGeometries()
+{
+    QMap<QString, QRect> geometries;
+    for (const QScreen *screen : qApp->screens()) {
+        geometries.insert(screen->name(), screen->geometry());
+    }
+
+    return geometries;
+}
+
+double ScreenGeometryProvider::scaleFactorFromConfig(const QString &config)
+{
+    if (config.isEmpty()) {
+        qCWarning(DDE_SHELL) << "Greeter get system display config failed (`GetConfig` null)";
+        return -1.0;
+    }
+
+    // 获取 ScaleFactors 对象
+    QJsonObject json = QJsonDocument::fromJson(config.toUtf8()).object();
+    QJsonObject scaleFactors = json.value("Config").toObject().value("ScaleFactors").toObject();
+
+    // 遍历 ScaleFactors 对象
+    for (const auto &key : scaleFactors.keys()) {
+        return scaleFactors.value(key).toDouble();
+    }
+
+    qCWarning(DDE_SHELL) << "greeter get system display config failed(`scaleFactors` null)";
+    return -1.0;
+}
+
+QMap<QString, QRect> ScreenGeometryProvider::queryGeometries(double scale)
+{
+    QMap<QString, QRect> screensGeometry;
+
+#ifndef ENABLE_DSS_SNIPE
+    Display *display = QX11Info::display();
+#else
+    Display *display = nullptr;
+    if (auto x11Application = qGuiApp->nativeInterface<QNativeInterface::QX11Application>())
+        display = x11Application->display();
+#endif
+    if (!display) {
+        qCWarning(DDE_SHELL) << "Display is null, can not get screen geometry by XRandR";
+        return screensGeometry;
+    }
+
+    // 只读取服务端当前的配置，不会触发重新探测输出设备
+    XRRScreenResources *resources = XRRGetScreenResourcesCurrent(display, DefaultRootWindow(display));
+    if (!resources) {
+        qCWarning(DDE_SHELL) << "Get current XRR screen resources failed";
+        return screensGeometry;
+    }
+
+    for (int i = 0; i < resources->noutput; i++) {
+        XRROutputInfo *outputInfo = XRRGetOutputInfo(display, resources, resources->outputs[i]);
+        if (!outputInfo)
+            continue;
+
+        if (outputInfo->connection == RR_Connected && outputInfo->crtc) {
+            XRRCrtcInfo *crtcInfo = XRRGetCrtcInfo(display, resources, outputInfo->crtc);
+            if (crtcInfo) {
+                const QString name = QString::fromLocal8Bit(outputInfo->name, outputInfo->nameLen);
+                QRect rect(crtcInfo->x, crtcInfo->y, static_cast<int>(crtcInfo->width / scale), static_cast<int>(crtcInfo->height / scale));
+                screensGeometry.insert(name, rect);
+                qCInfo(DDE_SHELL) << "Screen name:" << name << ", screen rect:" << rect;
+                XRRFreeCrtcInfo(crtcInfo);
+            }
+        }
+        XRRFreeOutputInfo(outputInfo);
+    }
+    XRRFreeScreenResources(resources);
+
+    return screensGeometry;
+}
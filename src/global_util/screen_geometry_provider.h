@@ -0,0 +1,64 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SCREEN_GEOMETRY_PROVIDER_H
+#define SCREEN_GEOMETRY_PROVIDER_H
+
+#include <QMap>
+#include <QObject>
+#include <QRect>
+
+#ifdef ENABLE_DSS_SNIPE
+#include "systemdisplay1interface.h"
+
+using SystemDisplayInter = org::deepin::dde::Display1;
+#else
+#include <com_deepin_system_systemdisplay.h>
+
+using SystemDisplayInter = com::deepin::system::Display;
+#endif
+
+/**
+ * @brief 所有全屏窗口共享的屏幕几何信息
+ *
+ * 登录界面修改分辨率后Qt获取的屏幕尺寸可能不正确，需要以XRandR的结果为准。
+ * 每次屏幕变化后只通过XRRGetScreenResourcesCurrent查询一次，结果由所有屏幕的窗口共享。
+ * 显示服务的缩放比例只在启动时异步获取一次，之后通过ConfigUpdated信号更新，
+ * 获取到缩放比例之前isReady()返回false，获取到之后发出geometriesUpdated信号。
+ */
+class ScreenGeometryProvider : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ScreenGeometryProvider(QObject *parent = nullptr);
+    static ScreenGeometryProvider *instance();
+
+    bool isReady() const;
+    QMap<QString, QRect> geometries();
+
+signals:
+    void geometriesUpdated();
+
+private slots:
+    void onDisplayConfigUpdated(const QString &config);
+    void invalidate();
+
+private:
+    void updateScaleFactor(double scaleFactor);
+    static QMap<QString, QRect> qtScreenGeometries();
+    static double scaleFactorFromConfig(const QString &config);
+    static QMap<QString, QRect> queryGeometries(double scale);
+
+private:
+    SystemDisplayInter *m_systemDisplay;
+    bool m_scaleFactorReady;
+    double m_scaleFactor;
+
+    // 查询结果和查询时Qt的屏幕布局，屏幕变化后结果失效
+    bool m_dirty;
+    QMap<QString, QRect> m_geometries;
+    QMap<QString, QRect> m_snapshot;
+};
+
+#endif // SCREEN_GEOMETRY_PROVIDER_H
@@ -0,0 +1,168 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "wallpaper_disk_cache.h"
+#include "constants.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char CACHE_MAGIC[4] = {'D', 'S', 'S', 'W'};
+const quint32 CACHE_VERSION = 1;
+// 每个尺寸只需要保留当前壁纸，留一些余量给多屏和切换用户
+const int MAX_CACHE_FILES = 16;
+
+struct CacheHeader {
+    char magic[4];
+    quint32 version;
+    quint32 width;
+    quint32 height;
+    quint32 bytesPerLine;
+    quint32 format;
+};
+
+struct MappedImage {
+    void *address;
+    size_t length;
+};
+
+void unmapImage(void *info)
+{
+    MappedImage *mapped = static_cast<MappedImage *>(info);
+    munmap(mapped->address, mapped->length);
+    delete mapped;
+}
+
+} // namespace
+
+QString WallpaperDiskCache::cacheDir()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/dde-session-shell/wallpaper";
+}
+
+QString WallpaperDiskCache::cacheFilePath(const QString &sourcePath, const QSize &size, qreal devicePixelRatio)
+{
+    const QFileInfo info(sourcePath);
+    const QString source = QString("%1|%2|%3").arg(sourcePath)
+                                              .arg(info.lastModified().toMSecsSinceEpoch())
+                                              .arg(info.size());
+    const QString hash = QCryptographicHash::hash(source.toUtf8(), QCryptographicHash::Md5).toHex();
+    return QString("%1/%2_%3x%4_%5.raw").arg(cacheDir())
+                                        .arg(hash)
+                                        .arg(size.width())
+                                        .arg(size.height())
+                                        .arg(devicePixelRatio);
+}
+
+/**
+ * @brief 读取缓存，缓存不存在或格式不对时返回空图片
+ */
+QImage WallpaperDiskCache::load(const QString &sourcePath, const QSize &size, qreal devicePixelRatio)
+{
+    const QByteArray filePath = cacheFilePath(sourcePath, size, devicePixelRatio).toLocal8Bit();
+    const int fd = open(filePath.constData(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return QImage();
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(CacheHeader))) {
+        close(fd);
+        return QImage();
+    }
+
+    const size_t length = static_cast<size_t>(st.st_size);
+    void *address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED) {
+        return QImage();
+    }
+
+    const CacheHeader *header = static_cast<const CacheHeader *>(address);
+    const bool valid = memcmp(header->magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0
+            && header->version == CACHE_VERSION
+            && header->width == static_cast<quint32>(size.width())
+            && header->height == static_cast<quint32>(size.height())
+            && header->format == static_cast<quint32>(QImage::Format_ARGB32_Premultiplied)
+            && header->bytesPerLine >= header->width * 4
+            && sizeof(CacheHeader) + static_cast<size_t>(header->bytesPerLine) * header->height <= length;
+    if (!valid) {
+        qCWarning(DDE_SHELL) << "Invalid wallpaper cache file:" << filePath;
+        munmap(address, length);
+        return QImage();
+    }
+
+    // QImage直接使用映射的内存，释放时解除映射
+    const uchar *data = static_cast<const uchar *>(address) + sizeof(CacheHeader);
+    QImage image(data, static_cast<int>(header->width), static_cast<int>(header->height),
+                 static_cast<int>(header->bytesPerLine), QImage::Format_ARGB32_Premultiplied,
+                 unmapImage, new MappedImage{address, length});
+    image.setDevicePixelRatio(devicePixelRatio);
+    return image;
+}
+
+/**
+ * @brief 保存缩放好的图片，先写临时文件再重命名，避免读到写了一半的缓存
+ */
+bool WallpaperDiskCache::save(const QString &sourcePath, const QSize &size, qreal devicePixelRatio, const QImage &image)
+{
+    if (image.isNull() || image.size() != size) {
+        return false;
+    }
+
+    const QString dirPath = cacheDir();
+    if (!QDir().mkpath(dirPath)) {
+        qCWarning(DDE_SHELL) << "Failed to create wallpaper cache dir:" << dirPath;
+        return false;
+    }
+
+    const QImage &argbImage = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    CacheHeader header;
+    memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.width = static_cast<quint32>(argbImage.width());
+    header.height = static_cast<quint32>(argbImage.height());
+    header.bytesPerLine = static_cast<quint32>(argbImage.bytesPerLine());
+    header.format = static_cast<quint32>(QImage::Format_ARGB32_Premultiplied);
+
+    QSaveFile file(cacheFilePath(sourcePath, size, devicePixelRatio));
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(DDE_SHELL) << "Failed to open wallpaper cache file:" << file.fileName();
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(argbImage.constBits()), static_cast<qint64>(header.bytesPerLine) * header.height);
+    if (!file.commit()) {
+        qCWarning(DDE_SHELL) << "Failed to write wallpaper cache file:" << file.fileName();
+        return false;
+    }
+
+    prune(dirPath);
+    return true;
+}
+
+/**
+ * @brief 只保留最近使用的缓存文件
+ */
+void WallpaperDiskCache::prune(const QString &dirPath)
+{
+    const QFileInfoList files = QDir(dirPath).entryInfoList({"*.raw"}, QDir::Files, QDir::Time);
+    for (int i = MAX_CACHE_FILES; i < files.size(); ++i) {
+        QFile::remove(files.at(i).absoluteFilePath());
+    }
+}
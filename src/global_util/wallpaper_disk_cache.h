@@ -0,0 +1,32 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef WALLPAPER_DISK_CACHE_H
+#define WALLPAPER_DISK_CACHE_H
+
+#include <QImage>
+#include <QString>
+
+/**
+ * @brief 缩放好的壁纸磁盘缓存
+ *
+ * 没有安装壁纸服务(dde-wallpaper-cache)时使用，避免每次启动都解码原图再缩放。
+ * 缓存文件是一个很小的文件头加上未压缩的ARGB32像素数据，读取时直接mmap，不需要解码。
+ * 文件名由源文件路径、修改时间、文件大小的哈希以及目标尺寸、缩放比例组成。
+ * 所有接口都是线程安全的，可以在壁纸处理线程中调用。
+ */
+class WallpaperDiskCache
+{
+public:
+    static QString cacheDir();
+    static QString cacheFilePath(const QString &sourcePath, const QSize &size, qreal devicePixelRatio);
+
+    static QImage load(const QString &sourcePath, const QSize &size, qreal devicePixelRatio);
+    static bool save(const QString &sourcePath, const QSize &size, qreal devicePixelRatio, const QImage &image);
+
+private:
+    static void prune(const QString &dirPath);
+};
+
+#endif // WALLPAPER_DISK_CACHE_H
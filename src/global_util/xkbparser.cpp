@@ -5,153 +5,279 @@
 #include "xkbparser.h"
 #include "constants.h"
 
-#include <QDomDocument>
+#include <QDataStream>
+#include <QDateTime>
 #include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QXmlStreamReader>
 
 #include <locale.h>
 #include <libintl.h>
 
+namespace {
+
+const char *BASE_FILE = "/usr/share/X11/xkb/rules/base.xml";
+const char XKB_DOMAIN[] = "xkeyboard-config";
+const quint32 CACHE_MAGIC = 0x44535358; // "DSSX"
+const quint32 CACHE_VERSION = 1;
+
+struct XkbData {
+    bool loaded = false;
+    XkbParser::Index index;
+    // 翻译只和当前语言有关，不写入磁盘缓存
+    QHash<QString, QString> translations;
+};
+
+}
+
+Q_GLOBAL_STATIC(XkbData, xkbData)
+
 XkbParser::XkbParser(QObject *parent)
     : QObject(parent)
 {
 }
 
-QStringList XkbParser::lookUpKeyboardList(QStringList keyboardList_key) {
-    if (KeyboardLayoutList.isEmpty()) {
-        parse();
-    }
+XkbParser::~XkbParser()
+{
+}
+
+QStringList XkbParser::lookUpKeyboardList(QStringList keyboardList_key)
+{
+    const Index &xkbIndex = index();
 
     QStringList result;
-    setlocale(LC_ALL, "");
-    const char xkbDomain[] = "xkeyboard-config";
-
-    for (int k = 0; k < keyboardList_key.length(); k++) {
-        QString tmpKey, head_key, tail_key;
-        tmpKey = keyboardList_key[k];
-        QStringList tmpKeyList = tmpKey.split(";");
-        if (tmpKeyList.length() == 2) {
-            head_key = tmpKeyList[0];
-            tail_key = tmpKeyList[1];
-
-            for (int i = 0; i < KeyboardLayoutList.length(); i++) {
-                if (KeyboardLayoutList[i].name == head_key) {
-                    if (tail_key.isEmpty()) {
-                        result << dgettext(xkbDomain, KeyboardLayoutList[i].description.toLatin1());
-                        break;
-                    } else {
-                        for (int j = 0; j < KeyboardLayoutList[i].variantItemList.length(); j++) {
-                            if (KeyboardLayoutList[i].variantItemList[j].name == tail_key) {
-                                result << dgettext(xkbDomain, KeyboardLayoutList[i].variantItemList[j].description.toLatin1());
-                            }
-                        }
-                        break;
-                    }
-                }
-            }
-        } else {
+    for (const QString &key : keyboardList_key) {
+        const QStringList keyList = key.split(";");
+        if (keyList.length() != 2) {
             continue;
         }
+
+        const QString &layout = keyList.at(0);
+        const QString &variant = keyList.at(1);
+        auto it = variant.isEmpty() ? xkbIndex.layouts.constFind(layout) : xkbIndex.variants.constFind(key);
+        const auto end = variant.isEmpty() ? xkbIndex.layouts.constEnd() : xkbIndex.variants.constEnd();
+        if (it != end) {
+            result << translate(it.value());
+        }
     }
 
     return result;
 }
+
 QString XkbParser::lookUpKeyboardKey(const QString &keyboard_value)
 {
-    if (KeyboardLayoutList.isEmpty()) {
-        parse();
-    }
-
-    QString keyboard_key = "";
-    for (int i = 0; i < KeyboardLayoutList.length(); i++) {
-        if (KeyboardLayoutList[i].description == keyboard_value) {
-            keyboard_key = QString("%1|").arg(KeyboardLayoutList[i].name);
-            qDebug() << "Look up keyboard key:" << keyboard_key;
-            return keyboard_key;
-        } else {
-            for (int j = 0; j < KeyboardLayoutList[i].variantItemList.length(); j++) {
-                if (KeyboardLayoutList[i].variantItemList[j].description == keyboard_value) {
-                    keyboard_key = QString("%1|%2").arg(KeyboardLayoutList[i].name).arg(KeyboardLayoutList[i].variantItemList[j].name);
-                    return keyboard_key;
+    return index().keys.value(keyboard_value);
+}
+
+/**
+ * @brief 使用 QXmlStreamReader 解析 base.xml 中的布局列表，只读取布局和变体的名称、描述
+ *
+ * @param baseFile base.xml 路径
+ * @param index 解析结果
+ * @return 是否解析到了布局
+ */
+bool XkbParser::parse(const QString &baseFile, Index &index)
+{
+    index = Index();
+
+    QFile file(baseFile);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(DDE_SHELL) << "Failed to open base.xml:" << baseFile;
+        return false;
+    }
+
+    QXmlStreamReader reader(&file);
+    bool inLayoutList = false;
+    bool inConfigItem = false;
+    bool inVariant = false;
+    QString layoutName;
+    QString name;
+    QString description;
+
+    while (!reader.atEnd()) {
+        reader.readNext();
+        if (reader.isStartElement()) {
+            if (reader.name() == QLatin1String("layoutList")) {
+                inLayoutList = true;
+            } else if (!inLayoutList) {
+                continue;
+            } else if (reader.name() == QLatin1String("layout")) {
+                layoutName.clear();
+            } else if (reader.name() == QLatin1String("variant")) {
+                inVariant = true;
+            } else if (reader.name() == QLatin1String("configItem")) {
+                inConfigItem = true;
+                name.clear();
+                description.clear();
+            } else if (inConfigItem && reader.name() == QLatin1String("name")) {
+                name = reader.readElementText();
+            } else if (inConfigItem && reader.name() == QLatin1String("description")) {
+                description = reader.readElementText();
+            }
+        } else if (reader.isEndElement() && inLayoutList) {
+            if (reader.name() == QLatin1String("layoutList")) {
+                // 后面的 optionList 不需要
+                break;
+            } else if (reader.name() == QLatin1String("variant")) {
+                inVariant = false;
+            } else if (reader.name() == QLatin1String("configItem")) {
+                inConfigItem = false;
+                // 布局的 configItem 在 variantList 之前，描述相同时布局优先
+                if (!inVariant) {
+                    layoutName = name;
+                    if (!index.layouts.contains(name)) {
+                        index.layouts.insert(name, description);
+                    }
+                    if (!index.keys.contains(description)) {
+                        index.keys.insert(description, QString("%1|").arg(name));
+                    }
+                } else if (!layoutName.isEmpty()) {
+                    const QString variantKey = QString("%1;%2").arg(layoutName).arg(name);
+                    if (!index.variants.contains(variantKey)) {
+                        index.variants.insert(variantKey, description);
+                    }
+                    if (!index.keys.contains(description)) {
+                        index.keys.insert(description, QString("%1|%2").arg(layoutName).arg(name));
+                    }
                 }
             }
         }
     }
-    return keyboard_key;
-}
 
-bool XkbParser::parse() {
+    if (reader.hasError()) {
+        qCWarning(DDE_SHELL) << "Failed to parse base.xml:" << reader.errorString() << ", line:" << reader.lineNumber();
+    }
 
-    QFile baseFile(kBaseFile);
+    if (index.isEmpty()) {
+        qCWarning(DDE_SHELL) << "Layout list is empty.";
+        return false;
+    }
 
-    QDomDocument document;
+    return true;
+}
 
-    if (baseFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        document.setContent(&baseFile);
-    } else {
-        qCWarning(DDE_SHELL) << "Failed to open base.xml";
+/**
+ * @brief 读取索引缓存，base.xml 的路径、修改时间或大小不一致时缓存无效
+ */
+bool XkbParser::loadCache(const QString &cacheFile, const QString &baseFile, Index &index)
+{
+    QFile file(cacheFile);
+    if (!file.open(QIODevice::ReadOnly)) {
         return false;
     }
 
-    QDomElement rootElement = document.documentElement();
+    const QFileInfo baseInfo(baseFile);
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
 
-    if (rootElement.isNull()) {
-        qCWarning(DDE_SHELL) << "Root element is null.";
+    quint32 magic = 0;
+    quint32 version = 0;
+    QString sourcePath;
+    qint64 sourceModified = 0;
+    qint64 sourceSize = 0;
+    stream >> magic >> version >> sourcePath >> sourceModified >> sourceSize;
+    if (stream.status() != QDataStream::Ok || magic != CACHE_MAGIC || version != CACHE_VERSION
+            || sourcePath != baseInfo.absoluteFilePath()
+            || sourceModified != baseInfo.lastModified().toMSecsSinceEpoch()
+            || sourceSize != baseInfo.size()) {
         return false;
     }
 
-    QDomElement layoutListElement = rootElement.firstChildElement("layoutList");
+    Index cached;
+    stream >> cached.layouts >> cached.variants >> cached.keys;
+    if (stream.status() != QDataStream::Ok || cached.isEmpty()) {
+        qCWarning(DDE_SHELL) << "Invalid xkb cache file:" << cacheFile;
+        return false;
+    }
 
-    QDomNodeList layoutNodes = layoutListElement.elementsByTagName("layout");
+    index = cached;
+    return true;
+}
 
-    if (layoutNodes.isEmpty()) {
-        qCWarning(DDE_SHELL) << "Layout list is empty.";
+/**
+ * @brief 保存索引缓存，先写临时文件再重命名
+ */
+bool XkbParser::saveCache(const QString &cacheFile, const QString &baseFile, const Index &index)
+{
+    if (!QDir().mkpath(QFileInfo(cacheFile).absolutePath())) {
+        qCWarning(DDE_SHELL) << "Failed to create xkb cache dir:" << cacheFile;
         return false;
     }
 
-    QDomNode layoutNode;
-    for (int layoutIndex = 0; layoutIndex < layoutNodes.size(); ++layoutIndex) {
-        VariantItem tmpVariantItem;
-
-        LayoutItem tmpLayoutItem;
+    QSaveFile file(cacheFile);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(DDE_SHELL) << "Failed to open xkb cache file:" << cacheFile;
+        return false;
+    }
 
-        layoutNode = layoutNodes.at(layoutIndex);
+    const QFileInfo baseInfo(baseFile);
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+    stream << CACHE_MAGIC << CACHE_VERSION
+           << baseInfo.absoluteFilePath()
+           << static_cast<qint64>(baseInfo.lastModified().toMSecsSinceEpoch())
+           << static_cast<qint64>(baseInfo.size());
+    stream << index.layouts << index.variants << index.keys;
 
-        QDomElement configElement = layoutNode.firstChildElement("configItem");
-        QDomElement nameElement = configElement.firstChildElement("name");
-        //get the Layout element: name
-        tmpLayoutItem.name = nameElement.text();
+    if (!file.commit()) {
+        qCWarning(DDE_SHELL) << "Failed to write xkb cache file:" << cacheFile;
+        return false;
+    }
+    return true;
+}
 
-        QDomElement descriptionElement = configElement.firstChildElement("description");
-        //get the Layout element: description
-        tmpLayoutItem.description = descriptionElement.text();
+QString XkbParser::cacheFilePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/dde-session-shell/xkb/base.cache";
+}
 
-        QDomElement variantListElement = layoutNode.firstChildElement("variantList");
-        QDomNodeList variantNodes = variantListElement.elementsByTagName("variant");
-        QDomNode variantNode;
-        for (int variantIndex = 0; variantIndex < variantNodes.size(); ++variantIndex) {
-            variantNode = variantNodes.at(variantIndex);
-            if (variantNode.isNull()) {
-                qCWarning(DDE_SHELL) << "Variant node is null";
-                continue;
-            }
+/**
+ * @brief 进程内共用的索引，第一次使用时读取缓存或者解析 base.xml
+ */
+const XkbParser::Index &XkbParser::index()
+{
+    XkbData *data = xkbData;
+    if (data->loaded) {
+        return data->index;
+    }
+    data->loaded = true;
 
-            QDomElement variantConfigElement = variantNode.firstChildElement("configItem");
-            if (variantConfigElement.isNull()) {
-                qCWarning(DDE_SHELL) << "Variant config element is null";
-                continue;
-            }
-            QDomElement variantNameElement = variantConfigElement.firstChildElement("name");
-            tmpVariantItem.name = variantNameElement.text();
-            QDomElement variantDescriptionElement = variantConfigElement.firstChildElement("description");
-            tmpVariantItem.description = variantDescriptionElement.text();
+    QElapsedTimer timer;
+    timer.start();
+    const QString cacheFile = cacheFilePath();
+    if (loadCache(cacheFile, BASE_FILE, data->index)) {
+        qCDebug(DDE_SHELL) << "Load xkb layouts from cache, elapsed:" << timer.elapsed() << "ms";
+        return data->index;
+    }
 
-            tmpLayoutItem.variantItemList.append(tmpVariantItem);
-        }
-        KeyboardLayoutList.append(tmpLayoutItem);
+    if (parse(BASE_FILE, data->index)) {
+        saveCache(cacheFile, BASE_FILE, data->index);
     }
-    return true;
+    qCInfo(DDE_SHELL) << "Parse xkb layouts, count:" << data->index.layouts.size() << ", elapsed:" << timer.elapsed() << "ms";
+    return data->index;
 }
 
-XkbParser::~XkbParser() {
+QString XkbParser::translate(const QString &description)
+{
+    XkbData *data = xkbData;
+    auto it = data->translations.constFind(description);
+    if (it != data->translations.constEnd()) {
+        return it.value();
+    }
+
+    // 只需要设置一次，之后的翻译都从缓存中获取
+    static bool localeInitialized = false;
+    if (!localeInitialized) {
+        setlocale(LC_ALL, "");
+        localeInitialized = true;
+    }
 
+    const QString translation = QString::fromUtf8(dgettext(XKB_DOMAIN, description.toUtf8().constData()));
+    data->translations.insert(description, translation);
+    return translation;
 }
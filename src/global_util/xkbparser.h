@@ -5,36 +5,42 @@
 #ifndef XKBPARSER_H
 #define XKBPARSER_H
 
-#include <QtXml>
-#include <QtXmlDepends>
+#include <QHash>
 #include <QObject>
-#include <QFile>
-
+#include <QStringList>
+
+/**
+ * @brief 键盘布局名称和描述的查询
+ *
+ * base.xml 只在进程中第一次查询时用 QXmlStreamReader 解析一次，结果保存在按名称和描述建立的索引中，
+ * 所有实例共用。索引同时写入磁盘缓存，base.xml 的修改时间和大小没有变化时，之后启动直接读取缓存。
+ */
 class XkbParser: public QObject
 {
 public:
     XkbParser(QObject *parent = nullptr);
     ~XkbParser() override;
 
-    struct VariantItem {
-        QString name;
-        QString description;
-    };
-    struct LayoutItem {
-        QString name;
-        QString description;
-        QList<VariantItem> variantItemList;
+    struct Index {
+        QHash<QString, QString> layouts;  // 布局名称 -> 描述
+        QHash<QString, QString> variants; // "布局名称;变体名称" -> 描述
+        QHash<QString, QString> keys;     // 描述 -> "布局名称|变体名称"，同一描述以第一次出现的为准
+
+        inline bool isEmpty() const { return layouts.isEmpty(); }
     };
-    QList<LayoutItem> KeyboardLayoutList;
+
+    static bool parse(const QString &baseFile, Index &index);
+    static bool loadCache(const QString &cacheFile, const QString &baseFile, Index &index);
+    static bool saveCache(const QString &cacheFile, const QString &baseFile, const Index &index);
+    static QString cacheFilePath();
 
 public slots:
     QStringList lookUpKeyboardList(QStringList keyboardList_key);
     QString lookUpKeyboardKey(const QString &keyboard_value);
 
 private:
-    const char* kBaseFile = "/usr/share/X11/xkb/rules/base.xml";
-
-    bool parse();
+    static const Index &index();
+    static QString translate(const QString &description);
 };
 
 #endif // XKBPARSER_H
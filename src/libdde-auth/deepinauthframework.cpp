@@ -7,6 +7,7 @@
 #include "authcommon.h"
 #include "public_func.h"
 #include "dbusconstant.h"
+#include "dpms_helper.h"
 
 #include <dlfcn.h>
 
@@ -27,10 +28,8 @@ using namespace AuthCommon;
 DeepinAuthFramework::DeepinAuthFramework(QObject *parent)
     : QObject(parent)
     , m_authenticateInter(new AuthInter(DSS_DBUS::authenticateService, DSS_DBUS::authenticatePath, QDBusConnection::systemBus(), this))
-    , m_PAMAuthThread(0)
+    , m_PAMAuthWorker(new PAMAuthWorker([this](const PAMAuthJobPtr &job) { PAMAuthentication(job); }))
     , m_authenticateControllers(new QMap<QString, AuthControllerInter *>())
-    , m_cancelAuth(false)
-    , m_waitToken(true)
     , m_isDAStartupCompleted(false)
 {
     connect(m_authenticateInter, &AuthInter::FrameworkStateChanged, this, &DeepinAuthFramework::FramworkStateChanged);
@@ -75,59 +74,38 @@ DeepinAuthFramework::~DeepinAuthFramework()
     }
     delete m_authenticateControllers;
     DestroyAuthenticate();
+    // 不等待 PAM 线程，卡在 PAM 模块中的线程在 PAM 返回后自行退出
+    delete m_PAMAuthWorker;
 }
 
 /**
- * @brief 创建一个 PAM 认证服务的线程，在线程中等待用户输入密码
+ * @brief 提交一个 PAM 认证任务，在 PAM 线程中等待用户输入密码
  *
  * @param account
  */
 void DeepinAuthFramework::CreateAuthenticate(const QString &account)
 {
-    if (account == m_account && m_PAMAuthThread != 0) {
+    if (IsUsingPamAuth() && m_PAMAuthJob->account() == account) {
         return;
     }
-    qCInfo(DDE_SHELL) << "Create PAM authenticate thread, accout: " << account << "PAM auth thread: " << m_PAMAuthThread;
-    m_account = account;
     DestroyAuthenticate();
-    m_cancelAuth = false;
-    m_waitToken = true;
-    int rc = pthread_create(&m_PAMAuthThread, nullptr, &PAMAuthWorker, this);
-
-    if (rc != 0) {
-        qCritical() << "ERROR: failed to create the authentication thread: %s" << strerror(errno);
-    }
-}
-
-/**
- * @brief 传入用户名
- *
- * @param arg   当前对象的指针
- * @return void*
- */
-void *DeepinAuthFramework::PAMAuthWorker(void *arg)
-{
-    DeepinAuthFramework *authFramework = static_cast<DeepinAuthFramework *>(arg);
-    if (authFramework != nullptr) {
-        authFramework->PAMAuthentication(authFramework->m_account);
-    } else {
-        qCritical() << "ERROR: pam auth worker deepin framework is nullptr";
-    }
-    return nullptr;
+    m_PAMAuthJob = m_PAMAuthWorker->submit(account);
+    qCInfo(DDE_SHELL) << "Create PAM authenticate job, accout: " << account << ", job id: " << m_PAMAuthJob->id();
 }
 
 /**
  * @brief 执行 PAM 认证
  *
- * @param account
+ * @param job 认证任务
  */
-void DeepinAuthFramework::PAMAuthentication(const QString &account)
+void DeepinAuthFramework::PAMAuthentication(const PAMAuthJobPtr &job)
 {
     pam_handle_t *m_pamHandle = nullptr;
-    pam_conv conv = {PAMConversation, static_cast<void *>(this)};
+    PAMConversationContext context = {this, job.get()};
+    pam_conv conv = {PAMConversation, static_cast<void *>(&context)};
     const char *serviceName = isDeepinAuth() ? PAM_SERVICE_DEEPIN_NAME : PAM_SERVICE_SYSTEM_NAME;
 
-    int ret = pam_start(serviceName, account.toLocal8Bit().data(), &conv, &m_pamHandle);
+    int ret = pam_start(serviceName, job->account().toLocal8Bit().data(), &conv, &m_pamHandle);
     if (ret != PAM_SUCCESS) {
         qCritical() << "ERROR: PAM start failed, error: " << pam_strerror(m_pamHandle, ret) << ", start infomation: " << ret;
     } else {
@@ -137,11 +115,11 @@ void DeepinAuthFramework::PAMAuthentication(const QString &account)
     int rc = pam_authenticate(m_pamHandle, 0);
     if (rc != PAM_SUCCESS) {
         qCWarning(DDE_SHELL) << "PAM authenticate failed, error: " << pam_strerror(m_pamHandle, rc) << ", PAM authenticate: " << rc;
-	if (m_message.isEmpty()){
-            if(rc == PAM_AUTH_ERR){
-                m_message = tr("Wrong Password");
-            }else{
-                m_message = pam_strerror(m_pamHandle, rc);
+        if (job->message().isEmpty()) {
+            if (rc == PAM_AUTH_ERR) {
+                job->setMessage(tr("Wrong Password"));
+            } else {
+                job->setMessage(pam_strerror(m_pamHandle, rc));
             }
         }
     } else {
@@ -155,14 +133,19 @@ void DeepinAuthFramework::PAMAuthentication(const QString &account)
         qCDebug(DDE_SHELL) << "PAM end...";
     }
 
+    // 被取消的任务不再通知界面，避免覆盖新任务的状态
+    if (job->isCancelled()) {
+        qCInfo(DDE_SHELL) << "PAM auth job cancelled:" << job->id();
+        return;
+    }
+
     if (rc == 0) {
-        UpdateAuthState(AS_Success, m_message);
+        UpdateAuthState(AS_Success, job->message());
     } else {
-        UpdateAuthState(AS_Failure, m_message);
+        UpdateAuthState(AS_Failure, job->message());
     }
 
-    m_PAMAuthThread = 0;
-    system("xset dpms force on");
+    DpmsHelper::instance()->wakeUp();
 }
 
 /**
@@ -176,10 +159,24 @@ void DeepinAuthFramework::PAMAuthentication(const QString &account)
  */
 int DeepinAuthFramework::PAMConversation(int num_msg, const pam_message **msg, pam_response **resp, void *app_data)
 {
-    DeepinAuthFramework *app_ptr = static_cast<DeepinAuthFramework *>(app_data);
+    PAMConversationContext *context = static_cast<PAMConversationContext *>(app_data);
+    DeepinAuthFramework *app_ptr = context ? context->framework : nullptr;
+    PAMAuthJob *job = context ? context->job : nullptr;
     struct pam_response *aresp = nullptr;
     int idx = 0;
 
+    if (!job) {
+        qCWarning(DDE_SHELL) << "PAM conversation: job is null";
+        return PAM_CONV_ERR;
+    }
+
+    // 协作式取消：任务被取消后，PAM 模块下一次回调时即退出认证
+    // 先于访问 app_ptr 检查，卡住的线程返回时登录器可能已经析构
+    if (job->isCancelled()) {
+        qCInfo(DDE_SHELL) << "PAM conversation: job cancelled:" << job->id();
+        return PAM_ABORT;
+    }
+
     QPointer<DeepinAuthFramework> isThreadAlive(app_ptr);
     if (!isThreadAlive) {
         qCWarning(DDE_SHELL) << "PAM conversation: application is null";
@@ -202,23 +199,18 @@ int DeepinAuthFramework::PAMConversation(int num_msg, const pam_message **msg, p
         case PAM_PROMPT_ECHO_OFF: {
             qCDebug(DDE_SHELL) << "PAM auth echo:" << message;
             app_ptr->UpdateAuthState(AS_Prompt, message);
-            /* 等待用户输入密码 */
-            while (app_ptr->m_waitToken) {
-                qCDebug(DDE_SHELL) << "Waiting for the password...";
-                if (app_ptr->m_cancelAuth) {
-                    app_ptr->m_cancelAuth = false;
-                    return PAM_ABORT;
+            /* 等待用户输入密码，收到密码或取消认证时立即唤醒 */
+            QString token;
+            if (!job->waitForToken(token)) {
+                qCInfo(DDE_SHELL) << "PAM conversation: job cancelled while waiting for token:" << job->id();
+                for (idx = 0; idx < num_msg; idx++) {
+                    free(aresp[idx].resp);
                 }
-                sleep(1);
-            }
-            app_ptr->m_waitToken = true;
-
-            if (!QPointer<DeepinAuthFramework>(app_ptr)) {
-                qCritical() << "ERROR: PAM deepin auth framework is null";
-                return PAM_CONV_ERR;
+                free(aresp);
+                return PAM_ABORT;
             }
 
-            aresp[idx].resp = strdup(app_ptr->m_token.toLocal8Bit().data());
+            aresp[idx].resp = strdup(token.toLocal8Bit().data());
 
             if (aresp[idx].resp == nullptr) {
                 goto fail;
@@ -229,14 +221,14 @@ int DeepinAuthFramework::PAMConversation(int num_msg, const pam_message **msg, p
         }
         case PAM_ERROR_MSG: {
             qCDebug(DDE_SHELL) << "PAM auth error: " << message;
-            app_ptr->m_message = message;
+            job->setMessage(message);
             app_ptr->UpdateAuthState(AS_Failure, message);
             aresp[idx].resp_retcode = PAM_SUCCESS;
             break;
         }
         case PAM_TEXT_INFO: {
             qCDebug(DDE_SHELL) << "PAM auth info: " << message;
-            app_ptr->m_message = message;
+            job->setMessage(message);
             app_ptr->UpdateAuthState(AS_Prompt, message);
             aresp[idx].resp_retcode = PAM_SUCCESS;
             break;
@@ -265,12 +257,10 @@ fail:
  */
 void DeepinAuthFramework::SendToken(const QString &token)
 {
-    if (!m_waitToken) {
+    if (!m_PAMAuthJob || !m_PAMAuthJob->sendToken(token)) {
         return;
     }
-    qCInfo(DDE_SHELL) << "Send token to PAM, token: " << token;
-    m_token = token;
-    m_waitToken = false;
+    qCInfo(DDE_SHELL) << "Send token to PAM, token: " << token << ", job id: " << m_PAMAuthJob->id();
 }
 
 /**
@@ -289,19 +279,18 @@ void DeepinAuthFramework::UpdateAuthState(const AuthState state, const QString &
  */
 void DeepinAuthFramework::DestroyAuthenticate()
 {
-    if (m_PAMAuthThread == 0) {
+    if (!m_PAMAuthJob) {
         return;
     }
-    qCInfo(DDE_SHELL) << "Destroy PAM authenticate thread";
-    m_cancelAuth = true;
-    pthread_cancel(m_PAMAuthThread);
-    pthread_join(m_PAMAuthThread, nullptr);
-    m_PAMAuthThread = 0;
+    qCInfo(DDE_SHELL) << "Destroy PAM authenticate job:" << m_PAMAuthJob->id();
+    // 不等待任务结束，PAM 线程会在下一次对话回调时退出认证
+    m_PAMAuthJob->cancel();
+    m_PAMAuthJob.reset();
 }
 
 bool DeepinAuthFramework::IsUsingPamAuth()
 {
-    return m_PAMAuthThread != 0;
+    return m_PAMAuthJob && !m_PAMAuthJob->isFinished();
 }
 
 /**
@@ -338,7 +327,7 @@ void DeepinAuthFramework::CreateAuthController(const QString &account, const Aut
         if (((AT_Face == type || AT_Iris == type) && AS_Success == authState)
             || (AT_Fingerprint == type && (AS_Failure == authState || AS_Success == authState))
             || (AT_Passkey == type && (AS_Failure == authState || AS_Success == authState))) {
-            system("xset dpms force on");
+            DpmsHelper::instance()->wakeUp();
         }
     });
 
@@ -6,6 +6,7 @@
 #define DEEPINAUTHFRAMEWORK_H
 
 #include "authcommon.h"
+#include "pam_auth_worker.h"
 
 #include <QObject>
 
@@ -96,24 +97,23 @@ public slots:
 
 private:
     /* Compatible with old authentication methods */
-    static void *PAMAuthWorker(void *arg);
-    void PAMAuthentication(const QString &account);
+    struct PAMConversationContext {
+        DeepinAuthFramework *framework;
+        PAMAuthJob *job;
+    };
+    void PAMAuthentication(const PAMAuthJobPtr &job);
     static int PAMConversation(int num_msg, const struct pam_message **msg, struct pam_response **resp, void *app_data);
     void UpdateAuthState(const AuthCommon::AuthState state, const QString &message);
 
 private:
     AuthInter *m_authenticateInter;
-    pthread_t m_PAMAuthThread;
-    QString m_account;
-    QString m_message;
-    QString m_token;
+    PAMAuthWorker *m_PAMAuthWorker;
+    PAMAuthJobPtr m_PAMAuthJob;
     int m_encryptType;
     QString m_publicKey;
     QString m_symmetricKey;
     ArrayInt m_encryptMethod;
     QMap<QString, AuthControllerInter *> *m_authenticateControllers;
-    bool m_cancelAuth;
-    bool m_waitToken;
     bool m_isDAStartupCompleted;
 
     QTimer m_authReminder;
@@ -0,0 +1,287 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "pam_auth_worker.h"
+#include "constants.h"
+
+#include <QDebug>
+#include <QList>
+#include <QMutexLocker>
+#include <QQueue>
+
+#include <thread>
+
+PAMAuthJob::PAMAuthJob(quint64 id, const QString &account)
+    : m_id(id)
+    , m_account(account)
+    , m_cancelled(false)
+    , m_finished(false)
+    , m_hasToken(false)
+{
+}
+
+/**
+ * @brief 取消任务，唤醒正在等待密码的 PAM 对话
+ */
+void PAMAuthJob::cancel()
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_cancelled) {
+        m_cancelTimer.start();
+    }
+    m_cancelled = true;
+    m_tokenCondition.wakeAll();
+}
+
+bool PAMAuthJob::isCancelled() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cancelled;
+}
+
+/**
+ * @brief 任务取消后超过 timeout 毫秒仍未结束，PAM 模块没有响应取消
+ */
+bool PAMAuthJob::isStuck(int timeout) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cancelled && !m_finished && m_cancelTimer.hasExpired(timeout);
+}
+
+void PAMAuthJob::setFinished()
+{
+    QMutexLocker locker(&m_mutex);
+    m_finished = true;
+    m_tokenCondition.wakeAll();
+}
+
+bool PAMAuthJob::isFinished() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_finished;
+}
+
+/**
+ * @brief 传入密码，已有未被取走的密码时忽略
+ *
+ * @return true 密码已被接收
+ */
+bool PAMAuthJob::sendToken(const QString &token)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_cancelled || m_finished || m_hasToken) {
+        return false;
+    }
+
+    m_token = token;
+    m_hasToken = true;
+    m_tokenCondition.wakeAll();
+    return true;
+}
+
+/**
+ * @brief 在 PAM 线程中阻塞等待密码
+ *
+ * @param token 取到的密码
+ * @return true 收到密码
+ * @return false 任务已被取消
+ */
+bool PAMAuthJob::waitForToken(QString &token)
+{
+    QMutexLocker locker(&m_mutex);
+    while (!m_hasToken && !m_cancelled) {
+        m_tokenCondition.wait(&m_mutex);
+    }
+
+    if (m_cancelled) {
+        return false;
+    }
+
+    token = m_token;
+    m_token.clear();
+    m_hasToken = false;
+    return true;
+}
+
+void PAMAuthJob::setMessage(const QString &message)
+{
+    QMutexLocker locker(&m_mutex);
+    m_message = message;
+}
+
+QString PAMAuthJob::message() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_message;
+}
+
+struct PAMAuthWorker::State {
+    JobHandler handler;
+    int threadCount;
+    int stuckTimeout;
+    QMutex mutex;
+    QWaitCondition jobCondition;
+    QWaitCondition watchCondition;
+    QQueue<PAMAuthJobPtr> pendingJobs;
+    QList<PAMAuthJobPtr> runningJobs;
+    int liveThreads = 0;
+    quint64 nextJobId = 1;
+    bool watching = false;
+    bool stopping = false;
+
+    bool hasWaitingJobs() const
+    {
+        return pendingJobs.size() > liveThreads - runningJobs.size();
+    }
+
+    int stuckJobs() const
+    {
+        int count = 0;
+        for (const PAMAuthJobPtr &job : runningJobs) {
+            if (job->isStuck(stuckTimeout)) {
+                ++count;
+            }
+        }
+        return count;
+    }
+};
+
+PAMAuthWorker::PAMAuthWorker(const JobHandler &handler, int threadCount, int stuckTimeout)
+    : m_state(std::make_shared<State>())
+{
+    m_state->handler = handler;
+    m_state->threadCount = qMax(1, threadCount);
+    m_state->stuckTimeout = qMax(0, stuckTimeout);
+}
+
+PAMAuthWorker::~PAMAuthWorker()
+{
+    QMutexLocker locker(&m_state->mutex);
+    m_state->stopping = true;
+    for (const PAMAuthJobPtr &job : qAsConst(m_state->pendingJobs)) {
+        job->cancel();
+        job->setFinished();
+    }
+    m_state->pendingJobs.clear();
+    for (const PAMAuthJobPtr &job : qAsConst(m_state->runningJobs)) {
+        job->cancel();
+    }
+    m_state->jobCondition.wakeAll();
+    m_state->watchCondition.wakeAll();
+
+    // 线程持有 m_state，不等待线程退出，卡住的线程在 PAM 返回后自行退出
+    if (!m_state->runningJobs.isEmpty()) {
+        qCInfo(DDE_SHELL) << "Leave PAM auth threads to exit on their own, running jobs:" << m_state->runningJobs.size();
+    }
+}
+
+/**
+ * @brief 提交一个认证任务，线程在第一次提交时按需创建
+ *
+ * @param account 用户名
+ * @return PAMAuthJobPtr 任务，用于传入密码和取消
+ */
+PAMAuthJobPtr PAMAuthWorker::submit(const QString &account)
+{
+    QMutexLocker locker(&m_state->mutex);
+    PAMAuthJobPtr job = std::make_shared<PAMAuthJob>(m_state->nextJobId++, account);
+    m_state->pendingJobs.enqueue(job);
+    startThreads(m_state);
+    m_state->jobCondition.wakeOne();
+
+    // 线程都在执行任务时，由监视线程在之前的任务取消超时后补充线程
+    if (m_state->hasWaitingJobs() && !m_state->watching) {
+        m_state->watching = true;
+        std::thread(&PAMAuthWorker::watch, m_state).detach();
+    }
+
+    qCInfo(DDE_SHELL) << "Submit PAM auth job:" << job->id() << ", account:" << account
+                      << ", pending jobs:" << m_state->pendingJobs.size() << ", running jobs:" << m_state->runningJobs.size();
+    return job;
+}
+
+/**
+ * @brief 取消所有排队和正在执行的任务，不等待任务结束
+ */
+void PAMAuthWorker::cancelAll()
+{
+    QMutexLocker locker(&m_state->mutex);
+    for (const PAMAuthJobPtr &job : qAsConst(m_state->pendingJobs)) {
+        job->cancel();
+        job->setFinished();
+    }
+    m_state->pendingJobs.clear();
+    for (const PAMAuthJobPtr &job : qAsConst(m_state->runningJobs)) {
+        job->cancel();
+    }
+}
+
+/**
+ * @brief 有任务排队时定期检查，为取消超时仍未结束的任务补充线程，没有任务排队后退出
+ */
+void PAMAuthWorker::watch(std::shared_ptr<State> state)
+{
+    const unsigned long interval = static_cast<unsigned long>(qMax(10, state->stuckTimeout / 10));
+    QMutexLocker locker(&state->mutex);
+    while (!state->stopping && state->hasWaitingJobs()) {
+        state->watchCondition.wait(&state->mutex, interval);
+        startThreads(state);
+    }
+    state->watching = false;
+}
+
+/**
+ * @brief 没有空闲线程处理排队的任务时创建线程，卡住的线程不计入线程数，调用前需要加锁
+ */
+void PAMAuthWorker::startThreads(const std::shared_ptr<State> &state)
+{
+    if (state->stopping) {
+        return;
+    }
+
+    const int stuckJobs = state->stuckJobs();
+    int idleThreads = state->liveThreads - state->runningJobs.size();
+    while (idleThreads < state->pendingJobs.size() && state->liveThreads - stuckJobs < state->threadCount) {
+        if (stuckJobs > 0) {
+            qCWarning(DDE_SHELL) << "PAM auth threads are blocked in PAM, start a replacement thread, blocked threads:" << stuckJobs;
+        }
+        std::thread(&PAMAuthWorker::run, state).detach();
+        ++state->liveThreads;
+        ++idleThreads;
+    }
+}
+
+void PAMAuthWorker::run(std::shared_ptr<State> state)
+{
+    while (true) {
+        PAMAuthJobPtr job;
+        {
+            QMutexLocker locker(&state->mutex);
+            while (state->pendingJobs.isEmpty() && !state->stopping) {
+                state->jobCondition.wait(&state->mutex);
+            }
+            if (state->stopping) {
+                --state->liveThreads;
+                return;
+            }
+            job = state->pendingJobs.dequeue();
+            state->runningJobs.append(job);
+        }
+
+        if (!job->isCancelled()) {
+            state->handler(job);
+        } else {
+            qCInfo(DDE_SHELL) << "Skip cancelled PAM auth job:" << job->id();
+        }
+        job->setFinished();
+
+        QMutexLocker locker(&state->mutex);
+        state->runningJobs.removeOne(job);
+        // 卡住期间已经补充了新线程，PAM 返回后多出来的线程退出
+        if (state->stopping || state->liveThreads - state->stuckJobs() > state->threadCount) {
+            --state->liveThreads;
+            return;
+        }
+    }
+}
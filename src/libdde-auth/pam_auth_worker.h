@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PAM_AUTH_WORKER_H
+#define PAM_AUTH_WORKER_H
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QString>
+#include <QWaitCondition>
+
+#include <functional>
+#include <memory>
+
+/**
+ * @brief 一次 PAM 认证任务
+ *
+ * 任务在 PAM 线程和界面线程之间传递密码，取消是协作式的：
+ * cancel() 会唤醒正在等待密码的 PAM 对话函数，由它返回 PAM_ABORT，
+ * 让 pam_authenticate 和 pam_end 正常走完，不会留下半销毁的 PAM 状态。
+ * 阻塞在 pam_authenticate 内部、不再回调对话函数的模块（如 fprintd、sss）无法被唤醒，
+ * 这类任务在取消超时后由 PAMAuthWorker 放弃所在的线程。
+ */
+class PAMAuthJob
+{
+public:
+    PAMAuthJob(quint64 id, const QString &account);
+
+    quint64 id() const { return m_id; }
+    QString account() const { return m_account; }
+
+    void cancel();
+    bool isCancelled() const;
+    bool isStuck(int timeout) const;
+
+    void setFinished();
+    bool isFinished() const;
+
+    bool sendToken(const QString &token);
+    bool waitForToken(QString &token);
+
+    void setMessage(const QString &message);
+    QString message() const;
+
+private:
+    const quint64 m_id;
+    const QString m_account;
+    mutable QMutex m_mutex;
+    QWaitCondition m_tokenCondition;
+    QElapsedTimer m_cancelTimer;
+    bool m_cancelled;
+    bool m_finished;
+    bool m_hasToken;
+    QString m_token;
+    QString m_message;
+};
+
+using PAMAuthJobPtr = std::shared_ptr<PAMAuthJob>;
+
+/**
+ * @brief 常驻的 PAM 认证线程池
+ *
+ * 线程在第一次提交任务时创建，之后一直复用，切换用户时只需要取消旧任务、提交新任务，
+ * 不再为每次切换创建和 pthread_cancel 线程。
+ * 任务取消后超过 stuckTimeout 仍未结束时，认为所在线程卡在 PAM 模块中，不再计入线程数，
+ * 有任务排队时由监视线程补充新的线程处理，调用者不需要做额外的处理；卡住的线程在 PAM 返回后自行退出。
+ * 线程都是分离的并共同持有线程池的状态，析构时不等待线程退出，不会阻塞界面线程。
+ */
+class PAMAuthWorker
+{
+public:
+    using JobHandler = std::function<void(const PAMAuthJobPtr &)>;
+
+    explicit PAMAuthWorker(const JobHandler &handler, int threadCount = 2, int stuckTimeout = 3000);
+    ~PAMAuthWorker();
+
+    PAMAuthJobPtr submit(const QString &account);
+    void cancelAll();
+
+private:
+    struct State;
+    static void startThreads(const std::shared_ptr<State> &state);
+    static void run(std::shared_ptr<State> state);
+    static void watch(std::shared_ptr<State> state);
+
+private:
+    std::shared_ptr<State> m_state;
+};
+
+#endif // PAM_AUTH_WORKER_H
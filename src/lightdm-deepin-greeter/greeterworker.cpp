@@ -9,6 +9,7 @@
 #include "userinfo.h"
 #include "dconfig_helper.h"
 #include "login_plugin_util.h"
+#include "nss_cache.h"
 
 #include <DSysInfo>
 
@@ -21,8 +22,6 @@
 #else
 #include "systempower1interface.h"
 #endif
-#include <pwd.h>
-#include </usr/include/shadow.h>
 
 #define SECURITY_ENHANCE_PATH "/com/deepin/daemon/SecurityEnhance"
 #define SECURITY_ENHANCE_NAME "com.deepin.daemon.SecurityEnhance"
@@ -39,6 +38,7 @@ DCORE_USE_NAMESPACE
 const int NUM_LOCKED = 0;   // 禁用小键盘
 const int NUM_UNLOCKED = 1; // 启用小键盘
 const int NUM_LOCK_UNKNOWN = 2; // 未知状态
+const QString NUM_LOCK_STATE = "numLockState";
 
 GreeterWorker::GreeterWorker(SessionBaseModel *const model, QObject *parent)
     : AuthInterface(model, parent)
@@ -61,6 +61,9 @@ GreeterWorker::GreeterWorker(SessionBaseModel *const model, QObject *parent)
 #endif
     checkDBusServer(m_accountsInter->isValid());
 
+    updateNumLockStates(DConfigHelper::instance()->getConfig(NUM_LOCK_STATE, QStringList()).toStringList());
+    DConfigHelper::instance()->bind(this, NUM_LOCK_STATE, &GreeterWorker::onDConfigPropertyChanged);
+
     initConnections();
     initData();
     initConfiguration();
@@ -660,26 +663,42 @@ void GreeterWorker::endAuthentication(const QString &account, const AuthFlags au
 void GreeterWorker::checkAccount(const QString &account, bool switchUser)
 {
     qCInfo(DDE_SHELL) << "Check account, account: " << account;
-    const auto &originalUsePtr = m_model->findUserByName(account);
-    std::shared_ptr<User> user_ptr = originalUsePtr;
+    // 新的检查取代还在等待账户数据的检查
+    m_checkingUser.reset();
+    std::shared_ptr<User> user_ptr = m_model->findUserByName(account);
     // 当用户登录成功后，判断用户输入帐户有效性逻辑改为后端去做处理
     const QString userPath = m_accountsInter->FindUserByName(account);
     if (userPath.startsWith("/")) {
+        // 账户数据异步返回，返回后再继续检查，不阻塞界面线程
         user_ptr = std::make_shared<NativeUser>(userPath);
-        // 对于没有设置密码的账户,直接认定为错误账户
-        if (!user_ptr->isPasswordValid()) {
-            qCWarning(DDE_SHELL) << "The user's password is invalid, user path: " << userPath;
-            emit m_model->accountError();
-            emit m_model->authFailedTipsMessage(tr("Wrong account"));
-            m_model->setAuthType(AT_None);
-            return;
-        }
+        m_checkingUser = user_ptr;
+        const std::weak_ptr<User> weakUser = user_ptr;
+        auto connection = std::make_shared<QMetaObject::Connection>();
+        *connection = connect(user_ptr.get(), &User::dataLoaded, this, [this, account, switchUser, userPath, weakUser, connection] {
+            disconnect(*connection);
+            const std::shared_ptr<User> user = weakUser.lock();
+            if (!user || user != m_checkingUser) {
+                qCInfo(DDE_SHELL) << "Account check is superseded, account: " << account;
+                return;
+            }
+            m_checkingUser.reset();
+
+            // 对于没有设置密码的账户,直接认定为错误账户
+            if (!user->isPasswordValid()) {
+                qCWarning(DDE_SHELL) << "The user's password is invalid, user path: " << userPath;
+                emit m_model->accountError();
+                emit m_model->authFailedTipsMessage(tr("Wrong account"));
+                m_model->setAuthType(AT_None);
+                return;
+            }
+            switchToCheckedAccount(account, switchUser, user);
+        });
+        return;
     } else if (!user_ptr) {
         // 判断账户第一次登录时的有效性
-        std::string str = account.toStdString();
-        passwd *pw = getpwnam(str.c_str());
-        if (pw) {
-            QString userName = pw->pw_name;
+        const NssCache::Passwd pw = NssCache::instance()->passwdByName(account);
+        if (pw.valid) {
+            QString userName = pw.name;
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
             QString userFullName = userName.left(userName.indexOf(QString("@")));
 #else
@@ -697,6 +716,18 @@ void GreeterWorker::checkAccount(const QString &account, bool switchUser)
         }
     }
 
+    switchToCheckedAccount(account, switchUser, user_ptr);
+}
+
+/**
+ * @brief 账户检查通过后切换到该账户并开始认证
+ *
+ * @param user_ptr 检查通过的用户，账户服务中的用户此时数据已经返回
+ */
+void GreeterWorker::switchToCheckedAccount(const QString &account, bool switchUser, std::shared_ptr<User> user_ptr)
+{
+    const auto &originalUsePtr = m_model->findUserByName(account);
+
     // m_greeter->cancelAuthentication后m_greeter的数据不会发生改变，当前账户如果是无密码登陆则不需要判断m_greeter认证数据
     if (m_greeter->authenticationUser() == account && m_account == account && !user_ptr->isNoPasswordLogin()) {
         qCInfo(DDE_SHELL) << "The current user is the incoming user, do not check again";
@@ -1020,8 +1051,15 @@ void GreeterWorker::onSessionCreated()
 
 void GreeterWorker::saveNumLockState(std::shared_ptr<User> user, bool on)
 {
-    QStringList list = DConfigHelper::instance()->getConfig("numLockState", QStringList()).toStringList();
+    if (!user)
+        return;
+
     const QString &userName = user->name();
+    auto it = m_numLockStates.constFind(userName);
+    if (it != m_numLockStates.constEnd() && it.value() == on)
+        return;
+
+    QStringList list = DConfigHelper::instance()->getConfig(NUM_LOCK_STATE, QStringList()).toStringList();
 
     // 移除当前用户的记录
     for (const QString &numLockState : list) {
@@ -1034,21 +1072,42 @@ void GreeterWorker::saveNumLockState(std::shared_ptr<User> user, bool on)
 
     // 插入当前用户的记录
     list.append(user->name() + ":" + (on ? "True" : "False"));
-    DConfigHelper::instance()->setConfig("numLockState", list);
+    m_numLockStates.insert(userName, on);
+    DConfigHelper::instance()->setConfig(NUM_LOCK_STATE, list);
 }
 
 int GreeterWorker::getNumLockState(const QString &userName)
 {
-    QStringList list = DConfigHelper::instance()->getConfig("numLockState", QStringList()).toStringList();
+    auto it = m_numLockStates.constFind(userName);
+    if (it == m_numLockStates.constEnd())
+        return NUM_LOCK_UNKNOWN;
+
+    return it.value() ? NUM_UNLOCKED : NUM_LOCKED;
+}
 
+/**
+ * @brief 解析配置中“用户名:True/False”格式的小键盘状态，配置变化时才重新解析
+ */
+void GreeterWorker::updateNumLockStates(const QStringList &list)
+{
+    m_numLockStates.clear();
+    m_numLockStates.reserve(list.size());
     for (const QString &numLockState : list) {
-        QStringList tmpList = numLockState.split(":");
-        if (tmpList.size() == 2 && tmpList.at(0) == userName) {
-            return "True" == tmpList.at(1) ? NUM_UNLOCKED : NUM_LOCKED;
+        const QStringList tmpList = numLockState.split(":");
+        // 和之前逐个查找的结果一致，同一用户以第一条记录为准
+        if (tmpList.size() == 2 && !m_numLockStates.contains(tmpList.at(0))) {
+            m_numLockStates.insert(tmpList.at(0), "True" == tmpList.at(1));
         }
     }
+}
+
+void GreeterWorker::onDConfigPropertyChanged(const QString &key, const QVariant &value, QObject *objPtr)
+{
+    auto obj = qobject_cast<GreeterWorker *>(objPtr);
+    if (!obj || key != NUM_LOCK_STATE)
+        return;
 
-    return NUM_LOCK_UNKNOWN;
+    obj->updateNumLockStates(value.toStringList());
 }
 
 void GreeterWorker::recoveryUserKBState(std::shared_ptr<User> user)
@@ -1110,15 +1169,14 @@ void GreeterWorker::screenSwitchByWldpms(bool active)
 
 void GreeterWorker::updatePasswordExpiredStateBySPName(const QString &account)
 {
-    std::string str = account.toStdString();
-    spwd *pw = getspnam(str.c_str());
+    const NssCache::Shadow pw = NssCache::instance()->shadow(account);
 
-    if (pw) {
+    if (pw.valid) {
         const int secondsPerDay = 60 * 60 * 24;
 
-        long int spMax = pw->sp_max;
-        long int spWarn = pw->sp_warn;
-        long int spLastChg = pw->sp_lstchg;
+        long int spMax = pw.maxDays;
+        long int spWarn = pw.warnDays;
+        long int spLastChg = pw.lastChange;
 
         User::ExpiredState state = User::ExpiredNormal;
         int days = 0;
@@ -80,11 +80,14 @@ private:
     void authenticationComplete();
     void saveNumLockState(std::shared_ptr<User> user, bool on);
     int getNumLockState(const QString &userName);
+    void updateNumLockStates(const QStringList &list);
+    static void onDConfigPropertyChanged(const QString &key, const QVariant &value, QObject *objPtr);
     void recoveryUserKBState(std::shared_ptr<User> user);
     void startGreeterAuth(const QString &account = QString());
     void changePasswd();
     void screenSwitchByWldpms(bool active);
     void updatePasswordExpiredStateBySPName(const QString &account);
+    void switchToCheckedAccount(const QString &account, bool switchUser, std::shared_ptr<User> user_ptr);
 #ifdef ENABLE_DSS_SNIPE
     void prepareShutdownSound();
 #endif
@@ -102,6 +105,8 @@ private:
     QString m_account;
     QString m_password;
     bool m_retryAuth;
+    QHash<QString, bool> m_numLockStates; // 用户名 -> 小键盘是否开启
+    std::shared_ptr<User> m_checkingUser; // 等待账户数据返回的用户
 };
 
 #endif  // GREETERWORKEK_H
@@ -5,6 +5,7 @@
 #include "auth_custom.h"
 
 #include "modules_loader.h"
+#include "plugin_dispatcher.h"
 #include "sessionbasemodel.h"
 
 #include <QBoxLayout>
@@ -77,6 +78,7 @@ void AuthCustom::setCallback()
         return;
     }
     m_plugin->setMessageCallback(&AuthCustom::messageCallback);
+    m_plugin->setStructuredMessageCallback(&AuthCustom::structuredMessageCallback);
     m_plugin->setAppData(this);
     m_plugin->setAuthCallback(&AuthCustom::authCallback);
 }
@@ -151,42 +153,49 @@ void AuthCustom::authCallback(const LoginPlugin::AuthCallbackData *callbackData,
     }
 }
 
+/**
+ * @brief 2.0.0 及以下插件的 json 字符串消息，解析后按结构化消息处理
+ */
 QString AuthCustom::messageCallback(const QString &message, void *app_data)
 {
     QJsonParseError jsonParseError;
-    const QJsonDocument messageDoc = QJsonDocument::fromJson(message.toLatin1(), &jsonParseError);
-
-    QJsonObject retObj;
-    QJsonObject dataObj;
-    retObj["Code"] = 0;
-    retObj["Message"] = "Success";
+    const QJsonDocument messageDoc = QJsonDocument::fromJson(message.toUtf8(), &jsonParseError);
     if (jsonParseError.error != QJsonParseError::NoError || messageDoc.isEmpty()) {
+        QJsonObject retObj;
         retObj["Code"] = -1;
         retObj["Message"] = "Failed to analysis message info";
         qCWarning(DDE_SHELL) << "Failed to analysis message from plugin: " << message;
         return toJson(retObj);
     }
 
-    QJsonObject messageObj = messageDoc.object();
+    return toJson(QJsonObject::fromVariantMap(structuredMessageCallback(messageDoc.object().toVariantMap(), app_data)));
+}
+
+QVariantMap AuthCustom::structuredMessageCallback(const QVariantMap &message, void *app_data)
+{
+    QVariantMap retObj;
+    QVariantMap dataObj;
+    retObj["Code"] = 0;
+    retObj["Message"] = "Success";
+
     AuthCustom *authCustom = getAuthCustomObj(app_data);
     if (!authCustom) {
         retObj["Code"] = -1;
         retObj["Message"] = "App data is nullptr!";
-        return toJson(retObj);
+        return retObj;
     }
 
     const SessionBaseModel *model = authCustom->getModel();
     if (!model) {
         retObj["Code"] = -1;
         retObj["Message"] = "Data model is nullptr!";
-        return toJson(retObj);
+        return retObj;
     }
 
-    QString cmdType = messageObj.value("CmdType").toString();
+    const QString cmdType = message.value("CmdType").toString();
     qCInfo(DDE_SHELL) << "Cmd type: " << cmdType;
     if (cmdType == "GetProperties") {
-        QJsonArray properties;
-        properties = messageObj.value("Data").toArray();
+        const QStringList properties = message.value("Data").toStringList();
 
         if (properties.contains("AppType")) {
             dataObj["AppType"] = model->appType();
@@ -194,7 +203,7 @@ QString AuthCustom::messageCallback(const QString &message, void *app_data)
 
         if (properties.contains("CurrentUser")) {
             if (model->currentUser()) {
-                QJsonObject user;
+                QVariantMap user;
                 user["Name"] = model->currentUser()->name();
                 user["Uid"] = static_cast<int>(model->currentUser()->uid());
                 dataObj["CurrentUser"] = user;
@@ -204,12 +213,12 @@ QString AuthCustom::messageCallback(const QString &message, void *app_data)
             }
         }
     } else if (cmdType == "setAuthTypeInfo") {
-        QJsonObject dataObj = messageObj.value("Data").toObject();
-        authCustom->changeAuthType(AUTH_TYPE_CAST(dataObj["AuthType"].toInt()));
+        const QVariantMap data = message.value("Data").toMap();
+        authCustom->changeAuthType(AUTH_TYPE_CAST(data.value("AuthType").toInt()));
     }
 
     retObj["Data"] = dataObj;
-    return toJson(retObj);
+    return retObj;
 }
 
 /**
@@ -328,12 +337,12 @@ void AuthCustom::lightdmAuthStarted()
     sendAuthToken();
 
     // Tell plugin that lightdm authentication started
-    QJsonObject message;
+    QVariantMap message;
     message["CmdType"] = "StartAuth";
-    QJsonObject retDataObj;
+    QVariantMap retDataObj;
     retDataObj["AuthObjectType"] = AuthObjectType::LightDM;
     message["Data"] = retDataObj;
-    QString result = m_plugin->message(toJson(message));
+    const QVariantMap &result = PluginDispatcher::instance()->call(m_plugin, message);
     qCInfo(DDE_SHELL) << "Plugin message: " << result;
 }
 
@@ -343,19 +352,13 @@ void AuthCustom::notifyAuthState(AuthCommon::AuthFlags authType, AuthCommon::Aut
     if (!m_plugin)
         return;
 
-    QJsonObject message;
-    message["CmdType"] = "AuthState";
-    QJsonObject retDataObj;
-    retDataObj["AuthType"] = static_cast<int>(authType);
-    retDataObj["AuthState"] = state;
-    message["Data"] = retDataObj;
-    m_plugin->message(toJson(message));
+    m_plugin->notifyAuthState(static_cast<int>(authType), state);
 }
 
 /**
  * @brief 将限制信息发给插件
  *
- * @param limitsInfoStr 插件信息的json数据
+ * @param limitsInfo 认证限制信息
  */
 void AuthCustom::setLimitsInfo(const QMap<int, User::LimitsInfo> &limitsInfo)
 {
@@ -363,16 +366,16 @@ void AuthCustom::setLimitsInfo(const QMap<int, User::LimitsInfo> &limitsInfo)
     if (!m_plugin)
         return;
 
-    QJsonArray array;
+    QVariantList array;
     auto it = limitsInfo.constBegin();
     while (it != limitsInfo.end()) {
-        array.append(it.value().toJson());
+        array.append(it.value().toVariantMap());
         ++it;
     }
-    QJsonObject message;
+    QVariantMap message;
     message["CmdType"] = "LimitsInfo";
     message["Data"] = array;
-    m_plugin->message(toJson(message));
+    PluginDispatcher::instance()->notify(m_plugin, message);
 }
 
 QJsonObject AuthCustom::getRootObj(const QString &jsonStr)
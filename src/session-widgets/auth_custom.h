@@ -62,6 +62,7 @@ private:
     void setCallback();
     static void authCallback(const LoginPlugin::AuthCallbackData *callbackData, void *app_data);
     static QString messageCallback(const QString &message, void *app_data);
+    static QVariantMap structuredMessageCallback(const QVariantMap &message, void *app_data);
     void setAuthData(const LoginPlugin::AuthCallbackData &callbackData);
     void updateConfig();
     void changeAuthType(AuthCommon::AuthType type);
@@ -6,9 +6,12 @@
 #include "sessionbasemodel.h"
 #include "userinfo.h"
 #include "dbusconstant.h"
+#include "dpms_helper.h"
+#include "nss_cache.h"
 
 #include <QProcessEnvironment>
 #include <QFile>
+#include <QSet>
 
 #define POWER_CAN_SLEEP "POWER_CAN_SLEEP"
 #define POWER_CAN_HIBERNATE "POWER_CAN_HIBERNATE"
@@ -25,7 +28,6 @@ AuthInterface::AuthInterface(SessionBaseModel *const model, QObject *parent)
     , m_dbusInter(new DBusObjectInter("org.freedesktop.DBus", "/org/freedesktop/DBus", QDBusConnection::systemBus(), this))
     , m_lastLogoutUid(0)
     , m_currentUserUid(0)
-    , m_loginUserList(0)
 {
 #ifndef ENABLE_DSS_SNIPE
     // 需要先初始化m_gsettings
@@ -43,6 +45,7 @@ AuthInterface::AuthInterface(SessionBaseModel *const model, QObject *parent)
        QString session_self = m_login1Inter->GetSessionByPID(0).value().path();
        m_login1SessionSelf = new Login1SessionSelf("org.freedesktop.login1", session_self, QDBusConnection::systemBus(), this);
        m_login1SessionSelf->setSync(false);
+       connect(m_login1SessionSelf, &Login1SessionSelf::ActiveChanged, DpmsHelper::instance(), &DpmsHelper::setSessionActive);
     } else {
         qCWarning(DDE_SHELL) << "Login interface is invalid, error:" << m_login1Inter->lastError().type();
     }
@@ -57,44 +60,48 @@ void AuthInterface::onUserListChanged(const QStringList &list)
 {
     m_model->setUserListSize(list.size());
 
-    QStringList tmpList;
+    // 所有增删合并成一次用户列表变化的通知
+    m_model->beginUserListUpdate();
+
+    QSet<QString> nativePaths;
     for (std::shared_ptr<User> u : m_model->userList()) {
         if (u->type() == User::Native)
-            tmpList << QString(DSS_DBUS::accountsUserPath).arg(QString::number(u->uid()));
+            nativePaths.insert(QString(DSS_DBUS::accountsUserPath).arg(QString::number(u->uid())));
     }
 
+    QSet<QString> paths;
+    paths.reserve(list.size());
     for (const QString &u : list) {
-        if (!tmpList.contains(u)) {
-            tmpList << u;
+        paths.insert(u);
+        if (!nativePaths.contains(u)) {
+            nativePaths.insert(u);
             onUserAdded(u);
         }
     }
 
-    for (const QString &u : tmpList) {
-        if (!list.contains(u)) {
+    for (const QString &u : qAsConst(nativePaths)) {
+        if (!paths.contains(u)) {
             onUserRemove(u);
         }
     }
 
+    m_model->commitUserListUpdate();
+
     m_loginedInter->userList();
 }
 
 void AuthInterface::onUserAdded(const QString &user)
 {
-    std::shared_ptr<User> user_ptr(new NativeUser(user));
+    std::shared_ptr<User> user_ptr(new NativeUser(user, NativeUser::LoadOnDemand));
     user_ptr->updateLoginState(isLogined(user_ptr->uid()));
     m_model->addUser(user_ptr);
 }
 
 void AuthInterface::onUserRemove(const QString &user)
 {
-    QList<std::shared_ptr<User>> list = m_model->userList();
-
-    for (auto u : list) {
-        if (u->path() == user && u->type() == User::Native) {
-            m_model->removeUser(u);
-            break;
-        }
+    std::shared_ptr<User> u = m_model->findUserByPath(user);
+    if (u && u->path() == user && u->type() == User::Native) {
+        m_model->removeUser(u);
     }
 }
 
@@ -114,6 +121,13 @@ void AuthInterface::initDBus()
     // m_accountsInter->setSync(false);
     // m_loginedInter->setSync(false);
 
+    // 用户增删后 NSS 缓存中的账户和用户组信息可能已经过时，需要在处理用户变化之前清空
+    auto invalidateNssCache = [] {
+        NssCache::instance()->invalidate();
+    };
+    connect(m_accountsInter, &AccountsInter::UserListChanged, this, invalidateNssCache, Qt::QueuedConnection);
+    connect(m_accountsInter, &AccountsInter::UserAdded, this, invalidateNssCache, Qt::QueuedConnection);
+    connect(m_accountsInter, &AccountsInter::UserDeleted, this, invalidateNssCache, Qt::QueuedConnection);
     connect(m_accountsInter, &AccountsInter::UserListChanged, this, &AuthInterface::onUserListChanged, Qt::QueuedConnection);
     connect(m_accountsInter, &AccountsInter::UserAdded, this, &AuthInterface::onUserAdded, Qt::QueuedConnection);
     connect(m_accountsInter, &AccountsInter::UserDeleted, this, &AuthInterface::onUserRemove, Qt::QueuedConnection);
@@ -123,27 +137,28 @@ void AuthInterface::initDBus()
 
 void AuthInterface::onLoginUserListChanged(const QString &list)
 {
-    m_loginUserList.clear();
-
-    std::list<uint> availableUidList;
-    std::transform(std::begin(m_model->userList()), std::end(m_model->userList()), std::back_inserter(availableUidList),
-                   [](std::shared_ptr<User> user) -> uint { return user->uid(); });
-
-    QJsonObject userList = QJsonDocument::fromJson(list.toUtf8()).object();
-    for (auto it = userList.constBegin(); it != userList.constEnd(); ++it) {
-        const bool haveDisplay = checkHaveDisplay(it.value().toArray());
-        const uint uid         = it.key().toUInt();
+    LoginedUserTracker::Diff diff;
+    if (!m_loginedUserTracker.update(list, diff)) {
+        qCWarning(DDE_SHELL) << "The logined user list is wrong!";
+        return;
+    }
+    if (diff.isEmpty()) {
+        return;
+    }
 
+    // 只处理会话有变化的用户
+    m_model->beginUserListUpdate();
+    for (const uint uid : diff.uids()) {
         // skip not have display users
+        const bool haveDisplay = m_loginedUserTracker.hasDisplay(uid);
         if (haveDisplay) {
-            m_loginUserList.push_back(uid);
+            m_loginUserList.insert(uid);
+        } else {
+            m_loginUserList.remove(uid);
         }
 
-        auto find_it = std::find_if(
-            availableUidList.begin(), availableUidList.end(),
-            [=](const uint find_adDomain_uid) { return find_adDomain_uid == uid; });
-
-        if (haveDisplay && find_it == availableUidList.end()) {
+        std::shared_ptr<User> user = m_model->findUserByUid(uid);
+        if (haveDisplay && !user) {
             // init adDomain user
             std::shared_ptr<User> u(new ADDomainUser(uid));
             u->updateLoginState(true);
@@ -152,37 +167,17 @@ void AuthInterface::onLoginUserListChanged(const QString &list)
                 m_model->updateCurrentUser(u);
             }
             m_model->addUser(u);
-            availableUidList.push_back(uid);
+        } else if (user) {
+            user->updateLoginState(haveDisplay);
         }
     }
-
-    QList<std::shared_ptr<User>> uList = m_model->userList();
-    for (auto it = uList.begin(); it != uList.end();) {
-        std::shared_ptr<User> user = *it;
-        user->updateLoginState(isLogined(user->uid()));
-        ++it;
-    }
+    m_model->commitUserListUpdate();
 
     if (m_model->isServerModel()) {
         emit m_model->userListLoginedChanged(m_model->loginedUserList());
     }
 }
 
-bool AuthInterface::checkHaveDisplay(const QJsonArray &array)
-{
-    for (auto it = array.constBegin(); it != array.constEnd(); ++it) {
-        const QJsonObject &obj = (*it).toObject();
-
-        // If user without desktop or display, this is system service, need skip.
-        if (!obj["Display"].toString().isEmpty() &&
-            !obj["Desktop"].toString().isEmpty()) {
-            return true;
-        }
-    }
-
-    return false;
-}
-
 #ifndef ENABLE_DSS_SNIPE
 QVariant AuthInterface::getGSettings(const QString& node, const QString& key)
 {
@@ -205,8 +200,7 @@ QVariant AuthInterface::getDconfigValue(const QString &key, const QVariant &fall
 
 bool AuthInterface::isLogined(uint uid)
 {
-    return std::any_of(m_loginUserList.begin(), m_loginUserList.end(),
-                       [uid](const uint UID) { return UID == uid; });
+    return m_loginUserList.contains(uid);
 }
 
 bool AuthInterface::isDeepin()
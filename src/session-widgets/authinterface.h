@@ -8,6 +8,7 @@
 #include "public_func.h"
 #include "constants.h"
 #include "dbuslogin1manager.h"
+#include "logined_user_tracker.h"
 
 #ifndef ENABLE_DSS_SNIPE
 #include <com_deepin_daemon_accounts.h>
@@ -28,6 +29,7 @@
 #endif
 
 #include <QObject>
+#include <QSet>
 #include <memory>
 
 #ifndef ENABLE_DSS_SNIPE
@@ -75,7 +77,6 @@ protected:
     void initData();
     void onLoginUserListChanged(const QString &list);
 
-    bool checkHaveDisplay(const QJsonArray &array);
     bool isLogined(uint uid);
     void checkConfig();
     void checkPowerInfo();
@@ -111,7 +112,8 @@ protected:
 #endif
     uint               m_lastLogoutUid;
     uint               m_currentUserUid;
-    std::list<uint>    m_loginUserList;
+    QSet<uint>         m_loginUserList;
+    LoginedUserTracker m_loginedUserTracker;
 };
 }  // namespace Auth
 
@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logined_user_tracker.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <algorithm>
+
+/**
+ * @brief 更新已登录用户列表
+ *
+ * @param userList Logined.UserList 的 json 数据，键为 uid，值为该用户的会话数组
+ * @param diff 和上一次相比变化的用户
+ * @return json 数据是否有效，无效时保留之前的数据
+ */
+bool LoginedUserTracker::update(const QString &userList, Diff &diff)
+{
+    diff = Diff();
+    if (userList == m_userList) {
+        return true;
+    }
+
+    QJsonParseError jsonParseError;
+    const QJsonDocument userListDoc = QJsonDocument::fromJson(userList.toUtf8(), &jsonParseError);
+    if (jsonParseError.error != QJsonParseError::NoError) {
+        return false;
+    }
+    m_userList = userList;
+
+    QHash<uint, QVector<Session>> sessions;
+    const QJsonObject userListObj = userListDoc.object();
+    sessions.reserve(userListObj.size());
+    for (auto it = userListObj.constBegin(); it != userListObj.constEnd(); ++it) {
+        bool ok = false;
+        const uint uid = it.key().toUInt(&ok);
+        if (!ok) {
+            continue;
+        }
+
+        const QJsonArray sessionArr = it.value().toArray();
+        QVector<Session> &userSessions = sessions[uid];
+        userSessions.reserve(sessionArr.size());
+        for (const QJsonValue &sessionValue : sessionArr) {
+            const QJsonObject sessionObj = sessionValue.toObject();
+            userSessions.append({ sessionObj["Display"].toString(), sessionObj["Desktop"].toString() });
+        }
+    }
+
+    for (auto it = sessions.constBegin(); it != sessions.constEnd(); ++it) {
+        auto oldIt = m_sessions.constFind(it.key());
+        if (oldIt == m_sessions.constEnd()) {
+            diff.loggedIn.append(it.key());
+        } else if (oldIt.value() != it.value()) {
+            diff.changed.append(it.key());
+        }
+    }
+    for (auto it = m_sessions.constBegin(); it != m_sessions.constEnd(); ++it) {
+        if (!sessions.contains(it.key())) {
+            diff.loggedOut.append(it.key());
+        }
+    }
+    m_sessions.swap(sessions);
+
+    return true;
+}
+
+void LoginedUserTracker::clear()
+{
+    m_userList.clear();
+    m_sessions.clear();
+}
+
+/**
+ * @brief 用户是否有桌面会话
+ */
+bool LoginedUserTracker::hasDesktop(uint uid) const
+{
+    const QVector<Session> userSessions = m_sessions.value(uid);
+    return std::any_of(userSessions.cbegin(), userSessions.cend(), [](const Session &session) {
+        return !session.desktop.isEmpty();
+    });
+}
+
+/**
+ * @brief 用户是否有带显示的桌面会话，没有的是系统服务等需要忽略的会话
+ */
+bool LoginedUserTracker::hasDisplay(uint uid) const
+{
+    const QVector<Session> userSessions = m_sessions.value(uid);
+    return std::any_of(userSessions.cbegin(), userSessions.cend(), [](const Session &session) {
+        return !session.display.isEmpty() && !session.desktop.isEmpty();
+    });
+}
@@ -0,0 +1,52 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGINED_USER_TRACKER_H
+#define LOGINED_USER_TRACKER_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief 已登录用户的会话索引
+ *
+ * 以 uid 为键保存 Logined.UserList 中每个用户的会话，列表变化时只比较有变化的用户，
+ * 给出新登录、全部退出和会话有变化的用户，使用方只需要处理这些用户。
+ */
+class LoginedUserTracker
+{
+public:
+    struct Session {
+        QString display; // 会话的显示，例如 :0
+        QString desktop; // 会话的桌面，为空时是系统服务等非图形会话
+
+        inline bool operator==(const Session &other) const { return display == other.display && desktop == other.desktop; }
+    };
+
+    struct Diff {
+        QList<uint> loggedIn;  // 新登录的用户
+        QList<uint> loggedOut; // 所有会话都已退出的用户
+        QList<uint> changed;   // 会话有变化的用户
+
+        inline bool isEmpty() const { return loggedIn.isEmpty() && loggedOut.isEmpty() && changed.isEmpty(); }
+        inline QList<uint> uids() const { return loggedIn + loggedOut + changed; }
+    };
+
+    bool update(const QString &userList, Diff &diff);
+    void clear();
+
+    inline bool contains(uint uid) const { return m_sessions.contains(uid); }
+    inline QVector<Session> sessions(uint uid) const { return m_sessions.value(uid); }
+    inline QList<uint> uids() const { return m_sessions.keys(); }
+    bool hasDesktop(uint uid) const;
+    bool hasDisplay(uint uid) const;
+
+private:
+    QString m_userList;
+    QHash<uint, QVector<Session>> m_sessions;
+};
+
+#endif // LOGINED_USER_TRACKER_H
@@ -7,9 +7,13 @@
 #include <DSysInfo>
 
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QSet>
+#include <QTimer>
 
 #include "dbusconstant.h"
 #include "dconfig_helper.h"
+#include "nss_cache.h"
 
 DCORE_USE_NAMESPACE
 
@@ -32,8 +36,10 @@ SessionBaseModel::SessionBaseModel(QObject *parent)
     , m_powerAction(PowerAction::RequireNormal)
     , m_currentModeState(ModeStatus::NoStatus)
     , m_authProperty {false, false, Unavailable, AuthCommon::AT_None, AuthCommon::None, 0, "", "", ""}
-    , m_users(new QMap<QString, std::shared_ptr<User>>())
+    , m_users(new UserRegistry(this))
     , m_loginedUsers(new QMap<QString, std::shared_ptr<User>>())
+    , m_userListUpdateDepth(0)
+    , m_userListUpdateScheduled(false)
     , m_updatePowerMode(UPM_None)
     , m_currentContentType(NoContent)
     , m_lightdmPamStarted(false)
@@ -50,7 +56,6 @@ SessionBaseModel::SessionBaseModel(QObject *parent)
 
 SessionBaseModel::~SessionBaseModel()
 {
-    delete m_users;
     delete m_loginedUsers;
 }
 
@@ -67,31 +72,17 @@ QVariant SessionBaseModel::getPowerGSettings(const QString &node, const QString
 
 std::shared_ptr<User> SessionBaseModel::findUserByUid(const uint uid) const
 {
-    for (auto user : qAsConst(*m_users)) {
-        if (user->uid() == uid) {
-            return user;
-        }
-    }
-    return std::shared_ptr<User>(nullptr);
+    return m_users->findByUid(uid);
 }
 
 std::shared_ptr<User> SessionBaseModel::findUserByName(const QString &name) const
 {
-    if (name.isEmpty()) {
-        return std::shared_ptr<User>(nullptr);
-    }
-
-    for (auto user : qAsConst(*m_users)) {
-        if (user->name() == name) {
-            return user;
-        }
-    }
-    return std::shared_ptr<User>(nullptr);
+    return m_users->findByName(name);
 }
 
 std::shared_ptr<User> SessionBaseModel::findUserByPath(const QString &path) const
 {
-    return m_users->value(path, std::shared_ptr<User>(nullptr));
+    return m_users->value(path);
 }
 
 void SessionBaseModel::setAppType(const AppType type)
@@ -293,10 +284,9 @@ void SessionBaseModel::addUser(const QString &path)
     if (m_users->contains(path)) {
         return;
     }
-    std::shared_ptr<NativeUser> user(new NativeUser(path));
+    std::shared_ptr<NativeUser> user(new NativeUser(path, NativeUser::LoadOnDemand));
     m_users->insert(path, user);
-    emit userAdded(user);
-    emit userListChanged(m_users->values());
+    recordUserAdded(user);
 }
 
 /**
@@ -308,13 +298,12 @@ void SessionBaseModel::addUser(const std::shared_ptr<User> user)
 {
     qInfo("Add user, path: %s, name: %s", qPrintable(user->path()), qPrintable(user->name()));
 
-    const QList<std::shared_ptr<User>> userList = m_users->values();
-    if (userList.contains(user)) {
+    if (m_users->contains(user)) {
         return;
     }
     const QString path = user->path().isEmpty() ? QString::number(user->uid()) : user->path();
     m_users->insert(path, user);
-    emit userAdded(user);
+    recordUserAdded(user);
 }
 
 /**
@@ -327,10 +316,8 @@ void SessionBaseModel::removeUser(const QString &path)
     if (!m_users->contains(path)) {
         return;
     }
-    const std::shared_ptr<User> user = m_users->value(path);
-    m_users->remove(path);
-    emit userRemoved(user);
-    emit userListChanged(m_users->values());
+    const std::shared_ptr<User> user = m_users->take(path);
+    recordUserRemoved(user);
 }
 
 /**
@@ -342,14 +329,144 @@ void SessionBaseModel::removeUser(const std::shared_ptr<User> user)
 {
     qInfo("Remove user, name: %s, id: %d", qPrintable(user->name()), user->uid());
 
-    const QList<std::shared_ptr<User>> userList = m_users->values();
-    if (!userList.contains(user)) {
+    if (!m_users->contains(user)) {
         return;
     }
 
-    const QString path = user->path().isEmpty() ? QString::number(user->uid()) : user->path();
-    m_users->remove(path);
-    emit userRemoved(user);
+    m_users->remove(m_users->pathOf(user));
+    recordUserRemoved(user);
+}
+
+/**
+ * @brief 开始批量更新用户列表
+ *
+ * 和 commitUserListUpdate 成对调用，期间的增删只记录下来，提交时合并成一次 userListUpdated 通知。
+ * 不在批量更新中的增删会合并到下一次事件循环时通知。
+ */
+void SessionBaseModel::beginUserListUpdate()
+{
+    ++m_userListUpdateDepth;
+}
+
+/**
+ * @brief 提交批量更新，最外层提交时立即通知用户列表的变化
+ */
+void SessionBaseModel::commitUserListUpdate()
+{
+    if (m_userListUpdateDepth <= 0) {
+        qCWarning(DDE_SHELL) << "Commit user list update without begin";
+        return;
+    }
+
+    if (--m_userListUpdateDepth == 0) {
+        flushUserListUpdate();
+    }
+}
+
+void SessionBaseModel::recordUserAdded(const std::shared_ptr<User> &user)
+{
+    // 登录状态变化也合并到用户列表的通知中
+    std::weak_ptr<User> weakUser = user;
+    connect(user.get(), &User::loginStateChanged, this, [this, weakUser] {
+        recordUserChanged(weakUser.lock());
+    });
+
+    auto it = m_pendingUserStates.find(user.get());
+    if (it == m_pendingUserStates.end()) {
+        m_pendingUsers.append(user);
+        m_pendingUserStates.insert(user.get(), PendingAdded);
+    } else if (it.value() == PendingRemoved) {
+        // 删除后又加回来，对接收方来说只是用户信息有变化
+        it.value() = PendingChanged;
+    }
+    scheduleUserListUpdate();
+}
+
+void SessionBaseModel::recordUserRemoved(const std::shared_ptr<User> &user)
+{
+    if (!user) {
+        return;
+    }
+
+    disconnect(user.get(), &User::loginStateChanged, this, nullptr);
+
+    auto it = m_pendingUserStates.find(user.get());
+    if (it == m_pendingUserStates.end()) {
+        m_pendingUsers.append(user);
+        m_pendingUserStates.insert(user.get(), PendingRemoved);
+    } else if (it.value() == PendingAdded) {
+        // 还没有通知过的用户，直接丢弃
+        m_pendingUserStates.erase(it);
+    } else {
+        it.value() = PendingRemoved;
+    }
+    scheduleUserListUpdate();
+}
+
+void SessionBaseModel::recordUserChanged(const std::shared_ptr<User> &user)
+{
+    if (!user || m_pendingUserStates.contains(user.get())) {
+        return;
+    }
+
+    m_pendingUsers.append(user);
+    m_pendingUserStates.insert(user.get(), PendingChanged);
+    scheduleUserListUpdate();
+}
+
+void SessionBaseModel::scheduleUserListUpdate()
+{
+    if (m_userListUpdateDepth > 0 || m_userListUpdateScheduled) {
+        return;
+    }
+
+    m_userListUpdateScheduled = true;
+    QTimer::singleShot(0, this, &SessionBaseModel::flushUserListUpdate);
+}
+
+/**
+ * @brief 把记录的变化合并成一次通知
+ */
+void SessionBaseModel::flushUserListUpdate()
+{
+    m_userListUpdateScheduled = false;
+    if (m_userListUpdateDepth > 0) {
+        return;
+    }
+
+    UserListDiff diff;
+    for (const std::shared_ptr<User> &user : qAsConst(m_pendingUsers)) {
+        auto it = m_pendingUserStates.find(user.get());
+        if (it == m_pendingUserStates.end()) {
+            continue;
+        }
+
+        switch (it.value()) {
+        case PendingAdded:
+            diff.added.append(user);
+            break;
+        case PendingRemoved:
+            diff.removed.append(user);
+            break;
+        case PendingChanged:
+            diff.changed.append(user);
+            break;
+        }
+        m_pendingUserStates.erase(it);
+    }
+    m_pendingUsers.clear();
+    m_pendingUserStates.clear();
+
+    if (diff.isEmpty()) {
+        return;
+    }
+
+    qCDebug(DDE_SHELL) << "User list updated, added:" << diff.added.size() << ", removed:" << diff.removed.size()
+                       << ", changed:" << diff.changed.size();
+    emit userListUpdated(diff);
+    if (!diff.added.isEmpty() || !diff.removed.isEmpty()) {
+        emit userListChanged(m_users->values());
+    }
 }
 
 /**
@@ -417,6 +534,9 @@ bool SessionBaseModel::updateCurrentUser(const std::shared_ptr<User> user)
         return false;
     }
 
+    // 轻量用户成为当前用户时才创建代理，数据异步返回
+    user->materialize();
+
     qCInfo(DDE_SHELL) << "Update current user:" << user->name();
 
     if (m_currentUser && *m_currentUser == *user) {
@@ -425,8 +545,23 @@ bool SessionBaseModel::updateCurrentUser(const std::shared_ptr<User> user)
         return false;
     }
 
+    disconnect(m_currentUserLoadedConnection);
     m_currentUser = user;
-    emit currentUserChanged(user);
+    // 域账户判断、免密登录组和密码有效期都需要查询 NSS，提前在后台线程中查询
+    if (!user->name().isEmpty()) {
+        NssCache::instance()->prefetch(QStringList() << user->name());
+    }
+
+    // 数据返回后再通知，收到通知时当前用户的账户信息是完整的
+    if (user->isLoading()) {
+        m_currentUserLoadedConnection = connect(user.get(), &User::dataLoaded, this, [this] {
+            disconnect(m_currentUserLoadedConnection);
+            qCInfo(DDE_SHELL) << "Current user data loaded:" << m_currentUser->name();
+            emit currentUserChanged(m_currentUser);
+        });
+    } else {
+        emit currentUserChanged(user);
+    }
 
     return true;
 }
@@ -439,19 +574,32 @@ bool SessionBaseModel::updateCurrentUser(const std::shared_ptr<User> user)
 void SessionBaseModel::updateUserList(const QStringList &list)
 {
     qCInfo(DDE_SHELL) << "Update user list: " << list;
-    QStringList listTmp = m_users->keys();
+    QElapsedTimer timer;
+    timer.start();
+    beginUserListUpdate();
+    int addedCount = 0;
+    QSet<QString> paths;
+    paths.reserve(list.size());
     for (const QString &path : list) {
-        if (m_users->contains(path)) {
-            listTmp.removeAll(path);
-        } else {
-            std::shared_ptr<NativeUser> user(new NativeUser(path));
+        paths.insert(path);
+        if (!m_users->contains(path)) {
+            // 只创建轻量用户，当前用户和列表中显示的用户再获取完整数据
+            std::shared_ptr<NativeUser> user(new NativeUser(path, NativeUser::LoadOnDemand));
             m_users->insert(path, user);
+            recordUserAdded(user);
+            ++addedCount;
         }
     }
-    for (const QString &path : qAsConst(listTmp)) {
-        m_users->remove(path);
+    int removedCount = 0;
+    const QStringList keys = m_users->keys();
+    for (const QString &path : keys) {
+        if (!paths.contains(path)) {
+            recordUserRemoved(m_users->take(path));
+            ++removedCount;
+        }
     }
-    emit userListChanged(m_users->values());
+    qCInfo(DDE_SHELL) << "Added" << addedCount << "user stubs, removed" << removedCount << "users, elapsed(ms):" << timer.elapsed();
+    commitUserListUpdate();
 }
 
 /**
@@ -463,43 +611,44 @@ void SessionBaseModel::updateLoginedUserList(const QString &list)
 {
     qCDebug(DDE_SHELL) << "Logined user list: " << list;
 
-    QList<QString> loginedUsersTmp = m_loginedUsers->keys();
-    QJsonParseError jsonParseError;
-    const QJsonDocument loginedUserListDoc = QJsonDocument::fromJson(list.toUtf8(), &jsonParseError);
-    if (jsonParseError.error != QJsonParseError::NoError) {
+    LoginedUserTracker::Diff diff;
+    if (!m_loginedUserTracker.update(list, diff)) {
         qCWarning(DDE_SHELL) << "The logined user list is wrong!";
         return;
     }
-    const QJsonObject loginedUserListDocObj = loginedUserListDoc.object();
-    for (const QString &loginedUserListDocKey : loginedUserListDocObj.keys()) {
-        const QJsonArray loginedUserListArr = loginedUserListDocObj.value(loginedUserListDocKey).toArray();
-        for (const QJsonValue &loginedUserStr : loginedUserListArr) {
-            const QJsonObject loginedUserListObj = loginedUserStr.toObject();
-            const int uid = loginedUserListObj["Uid"].toInt();
-            const QString &desktop = loginedUserListObj["Desktop"].toString();
-            if ((uid != 0 && uid < 1000) || desktop.isEmpty()) {
-                // 排除非正常登录用户
-                continue;
-            }
-            const QString path = QString(DSS_DBUS::accountsUserPath).arg(QString::number(uid));
-            if (!m_loginedUsers->contains(path)) {
-                // 对于通过自定义窗口输入的账户(域账户), 此时账户还没添加进来，导致下面m_users->value(path)为空指针，调用会导致程序奔溃
-                // 因此在登录时，对于新增的账户，调用addUser先将账户添加进来，然后再去更新对应账户的登录状态
-                addUser(path);
-                m_loginedUsers->insert(path, m_users->value(path));
-                m_users->value(path)->updateLoginState(true);
-            } else {
-                loginedUsersTmp.removeAll(path);
+    if (diff.isEmpty()) {
+        return;
+    }
+
+    // 只处理会话有变化的用户
+    bool loginedUsersChanged = false;
+    beginUserListUpdate();
+    for (const uint uid : diff.uids()) {
+        // 排除非正常登录用户
+        const bool isLogined = (uid == 0 || uid >= 1000) && m_loginedUserTracker.hasDesktop(uid);
+        const QString path = QString(DSS_DBUS::accountsUserPath).arg(QString::number(uid));
+        if (isLogined && !m_loginedUsers->contains(path)) {
+            // 对于通过自定义窗口输入的账户(域账户), 此时账户还没添加进来，导致下面m_users->value(path)为空指针，调用会导致程序奔溃
+            // 因此在登录时，对于新增的账户，调用addUser先将账户添加进来，然后再去更新对应账户的登录状态
+            addUser(path);
+            m_loginedUsers->insert(path, m_users->value(path));
+            m_users->value(path)->updateLoginState(true);
+            loginedUsersChanged = true;
+        } else if (!isLogined && m_loginedUsers->contains(path)) {
+            m_loginedUsers->remove(path);
+            const std::shared_ptr<User> user = m_users->value(path);
+            if (user) {
+                user->updateLoginState(false);
             }
+            loginedUsersChanged = true;
         }
     }
-    for (const QString &path : qAsConst(loginedUsersTmp)) {
-        m_loginedUsers->remove(path);
-        m_users->value(path)->updateLoginState(false);
-    }
+    commitUserListUpdate();
 
-    qCInfo(DDE_SHELL) << "Logined users: " << m_loginedUsers->keys();
-    emit loginedUserListChanged(m_loginedUsers->values());
+    if (loginedUsersChanged) {
+        qCInfo(DDE_SHELL) << "Logined users: " << m_loginedUsers->keys();
+        emit loginedUserListChanged(m_loginedUsers->values());
+    }
 }
 
 /**
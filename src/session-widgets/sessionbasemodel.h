@@ -6,8 +6,11 @@
 #define SESSIONBASEMODEL_H
 
 #include "authcommon.h"
+#include "logined_user_tracker.h"
 #include "userinfo.h"
+#include "user_registry.h"
 
+#include <QHash>
 #include <QObject>
 #ifndef ENABLE_DSS_SNIPE
 #include <QGSettings>
@@ -94,6 +97,15 @@ public:
         QString authMessage;     // 认证消息
     };
 
+    /* 一次事件循环内用户列表的变化 */
+    struct UserListDiff {
+        QList<std::shared_ptr<User>> added;   // 新增的用户
+        QList<std::shared_ptr<User>> removed; // 删除的用户
+        QList<std::shared_ptr<User>> changed; // 登录状态等信息变化的用户
+
+        inline bool isEmpty() const { return added.isEmpty() && removed.isEmpty() && changed.isEmpty(); }
+    };
+
     explicit SessionBaseModel(QObject *parent = nullptr);
     ~SessionBaseModel() override;
 
@@ -187,12 +199,14 @@ public:
     inline bool isQuickLoginProcess() const { return m_isQuickLoginProcess; }
     void setQuickLoginProcess(bool );
 
+    void beginUserListUpdate();
+    void commitUserListUpdate();
+
 signals:
     /* com.deepin.daemon.Accounts */
     void currentUserChanged(const std::shared_ptr<User>);
-    void userAdded(const std::shared_ptr<User>);
-    void userRemoved(const std::shared_ptr<User>);
     void userListChanged(const QList<std::shared_ptr<User>>);
+    void userListUpdated(const SessionBaseModel::UserListDiff &diff);
     void loginedUserListChanged(const QList<std::shared_ptr<User>>);
     /* com.deepin.daemon.Authenticate */
     void MFAFlagChanged(const bool);
@@ -276,6 +290,19 @@ protected:
                                        failback);
     }
 
+private:
+    enum PendingUserState {
+        PendingAdded,
+        PendingRemoved,
+        PendingChanged
+    };
+
+    void recordUserAdded(const std::shared_ptr<User> &user);
+    void recordUserRemoved(const std::shared_ptr<User> &user);
+    void recordUserChanged(const std::shared_ptr<User> &user);
+    void scheduleUserListUpdate();
+    void flushUserListUpdate();
+
 private:
     bool m_hasSwap;
     bool m_visible;
@@ -290,6 +317,7 @@ private:
     bool m_SEOpen; // 保存等保开启、关闭的状态
     bool m_isUseWayland;
     int m_userListSize = 0;
+    QMetaObject::Connection m_currentUserLoadedConnection;
     bool m_isTerminalLocked = false;
     bool m_userlistVisible = true;
     AppType m_appType;
@@ -299,8 +327,13 @@ private:
     PowerAction m_powerAction;
     ModeStatus m_currentModeState;
     AuthProperty m_authProperty; // 认证相关属性的值，初始时通过dbus获取，暂存在model中，供widget初始化界面使用
-    QMap<QString, std::shared_ptr<User>> *m_users;
+    UserRegistry *m_users;
     QMap<QString, std::shared_ptr<User>> *m_loginedUsers;
+    LoginedUserTracker m_loginedUserTracker;
+    int m_userListUpdateDepth;                                 // beginUserListUpdate 嵌套的层数
+    bool m_userListUpdateScheduled;                            // 是否已经安排在下一次事件循环通知
+    QList<std::shared_ptr<User>> m_pendingUsers;               // 按变化顺序记录的用户
+    QHash<const User *, PendingUserState> m_pendingUserStates; // 用户合并后的变化
     UpdatePowerMode m_updatePowerMode;
     ContentType m_currentContentType;
 #ifndef ENABLE_DSS_SNIPE
@@ -0,0 +1,152 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "user_registry.h"
+#include "userinfo.h"
+
+#include <algorithm>
+
+UserRegistry::UserRegistry(QObject *parent)
+    : QObject(parent)
+{
+}
+
+bool UserRegistry::contains(const QString &path) const
+{
+    return m_users.contains(path);
+}
+
+bool UserRegistry::contains(const std::shared_ptr<User> &user) const
+{
+    return user && m_entries.contains(user.get());
+}
+
+/**
+ * @brief 添加用户，路径已经存在时替换原来的用户
+ *
+ * @param path 用户路径或 uid
+ * @param user
+ */
+void UserRegistry::insert(const QString &path, const std::shared_ptr<User> &user)
+{
+    if (!user) {
+        return;
+    }
+
+    remove(path);
+    if (contains(user)) {
+        remove(m_entries.value(user.get()).path);
+    }
+
+    m_users.insert(path, user);
+    addIndex(user.get(), path);
+
+    const User *userPtr = user.get();
+    connect(user.get(), &User::nameChanged, this, [this, userPtr] {
+        reindex(userPtr);
+    });
+    connect(user.get(), &User::uidChanged, this, [this, userPtr] {
+        reindex(userPtr);
+    });
+}
+
+std::shared_ptr<User> UserRegistry::take(const QString &path)
+{
+    const std::shared_ptr<User> user = m_users.take(path);
+    if (user) {
+        removeIndex(user.get());
+        disconnect(user.get(), nullptr, this, nullptr);
+    }
+
+    return user;
+}
+
+void UserRegistry::remove(const QString &path)
+{
+    take(path);
+}
+
+void UserRegistry::clear()
+{
+    for (const std::shared_ptr<User> &user : qAsConst(m_users)) {
+        disconnect(user.get(), nullptr, this, nullptr);
+    }
+    m_users.clear();
+    m_entries.clear();
+    m_uidIndex.clear();
+    m_nameIndex.clear();
+}
+
+std::shared_ptr<User> UserRegistry::value(const QString &path) const
+{
+    return m_users.value(path, std::shared_ptr<User>(nullptr));
+}
+
+std::shared_ptr<User> UserRegistry::findByUid(uint uid) const
+{
+    return value(firstPath(m_uidIndex.values(uid)));
+}
+
+std::shared_ptr<User> UserRegistry::findByName(const QString &name) const
+{
+    if (name.isEmpty()) {
+        return std::shared_ptr<User>(nullptr);
+    }
+
+    return value(firstPath(m_nameIndex.values(name)));
+}
+
+QString UserRegistry::pathOf(const std::shared_ptr<User> &user) const
+{
+    return user ? m_entries.value(user.get()).path : QString();
+}
+
+void UserRegistry::addIndex(const User *user, const QString &path)
+{
+    const IndexEntry entry { path, user->uid(), user->name() };
+    m_entries.insert(user, entry);
+    m_uidIndex.insert(entry.uid, path);
+    if (!entry.name.isEmpty()) {
+        m_nameIndex.insert(entry.name, path);
+    }
+}
+
+void UserRegistry::removeIndex(const User *user)
+{
+    const auto it = m_entries.constFind(user);
+    if (it == m_entries.constEnd()) {
+        return;
+    }
+
+    m_uidIndex.remove(it->uid, it->path);
+    m_nameIndex.remove(it->name, it->path);
+    m_entries.erase(it);
+}
+
+/**
+ * @brief 用户名或 uid 变化后更新索引
+ */
+void UserRegistry::reindex(const User *user)
+{
+    const auto it = m_entries.constFind(user);
+    if (it == m_entries.constEnd()) {
+        return;
+    }
+
+    const QString path = it->path;
+    removeIndex(user);
+    addIndex(user, path);
+}
+
+/**
+ * @brief 多个用户 uid 或用户名相同时取路径最小的，和按路径顺序遍历的结果保持一致
+ */
+QString UserRegistry::firstPath(const QList<QString> &paths) const
+{
+    if (paths.isEmpty()) {
+        return QString();
+    }
+
+    return *std::min_element(paths.cbegin(), paths.cend());
+}
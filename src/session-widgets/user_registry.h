@@ -0,0 +1,68 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef USER_REGISTRY_H
+#define USER_REGISTRY_H
+
+#include <QHash>
+#include <QMap>
+#include <QMultiHash>
+#include <QObject>
+
+#include <memory>
+
+class User;
+
+/**
+ * @brief 用户列表
+ *
+ * 以用户路径（或 uid）为键按顺序保存用户，同时维护 uid、用户名和用户对象的哈希索引，
+ * 按 uid、用户名查找不再需要遍历所有用户。用户名或 uid 变化时会自动更新索引。
+ * 多个用户的 uid 或用户名相同时，返回路径排在最前面的用户，和遍历查找的结果一致。
+ */
+class UserRegistry : public QObject
+{
+    Q_OBJECT
+public:
+    explicit UserRegistry(QObject *parent = nullptr);
+
+    bool contains(const QString &path) const;
+    bool contains(const std::shared_ptr<User> &user) const;
+    void insert(const QString &path, const std::shared_ptr<User> &user);
+    std::shared_ptr<User> take(const QString &path);
+    void remove(const QString &path);
+    void clear();
+
+    std::shared_ptr<User> value(const QString &path) const;
+    std::shared_ptr<User> findByUid(uint uid) const;
+    std::shared_ptr<User> findByName(const QString &name) const;
+    QString pathOf(const std::shared_ptr<User> &user) const;
+
+    inline QList<std::shared_ptr<User>> values() const { return m_users.values(); }
+    inline QStringList keys() const { return m_users.keys(); }
+    inline std::shared_ptr<User> first() const { return m_users.first(); }
+    inline bool isEmpty() const { return m_users.isEmpty(); }
+    inline int size() const { return m_users.size(); }
+
+private:
+    struct IndexEntry
+    {
+        QString path;
+        uint uid;
+        QString name;
+    };
+
+    void addIndex(const User *user, const QString &path);
+    void removeIndex(const User *user);
+    void reindex(const User *user);
+    QString firstPath(const QList<QString> &paths) const;
+
+private:
+    QMap<QString, std::shared_ptr<User>> m_users;
+    QHash<const User *, IndexEntry> m_entries;
+    QMultiHash<uint, QString> m_uidIndex;
+    QMultiHash<QString, QString> m_nameIndex;
+};
+
+#endif // USER_REGISTRY_H
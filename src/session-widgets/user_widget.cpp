@@ -25,6 +25,7 @@ UserWidget::UserWidget(QWidget *parent)
     , m_blurEffectWidget(new DBlurEffectWidget(this))
     , m_avatar(new UserAvatar(this))
     , m_loginState(new DLabel(this))
+    , m_domainUserLabel(new DLabel(this))
     , m_displayNameLabel(new DLabel(this))
     , m_displayNameWidget(new QWidget(this))
     , m_userNameWidget(nullptr)
@@ -74,14 +75,13 @@ void UserWidget::initUI()
     // 域账户标识
     QPixmap domainUserpixmap = QIcon::fromTheme(":/misc/images/domainUser.svg").pixmap(24, 24);
     domainUserpixmap.setDevicePixelRatio(devicePixelRatioF());
-    DLabel *domainUserLabel = new DLabel(this);
-    domainUserLabel->setAccessibleName("isDomainUser");
-    domainUserLabel->setPixmap(domainUserpixmap);
-    domainUserLabel->setVisible(m_user->isDomainUser());
-    domainUserLabel->setAlignment(Qt::AlignVCenter);
+    m_domainUserLabel->setAccessibleName("isDomainUser");
+    m_domainUserLabel->setPixmap(domainUserpixmap);
+    m_domainUserLabel->setVisible(m_user->isDomainUser());
+    m_domainUserLabel->setAlignment(Qt::AlignVCenter);
     QVBoxLayout *isDomainUserLayout = new QVBoxLayout;
     isDomainUserLayout->setContentsMargins(0, 5, 0, 0);
-    isDomainUserLayout->addWidget(domainUserLabel);
+    isDomainUserLayout->addWidget(m_domainUserLabel);
     nameLayout->addLayout(isDomainUserLayout);
 
     m_displayNameLabel->setAccessibleName("NameLabel");
@@ -127,29 +127,60 @@ void UserWidget::initUI()
 }
 
 void UserWidget::initConnections()
+{
+    connect(qGuiApp, &QGuiApplication::fontChanged, this, &UserWidget::updateUserNameLabel);
+    connect(m_avatar, &UserAvatar::clicked, this, &UserWidget::clicked);
+}
+
+void UserWidget::initUserConnections()
 {
     connect(m_user.get(), &User::avatarChanged, this, &UserWidget::setAvatar);
     connect(m_user.get(), &User::displayNameChanged, this, &UserWidget::updateUserNameLabel);
     connect(m_user.get(), &User::loginStateChanged, this, &UserWidget::setLoginState);
-    connect(qGuiApp, &QGuiApplication::fontChanged, this, &UserWidget::updateUserNameLabel);
-    connect(m_avatar, &UserAvatar::clicked, this, &UserWidget::clicked);
+    // 账户数据异步返回前显示默认头像和名称，返回后更新
+    connect(m_user.get(), &User::dataLoaded, this, [this] {
+        setUid(m_user->uid());
+        updateUserInfo();
+        updateUserNameLabel();
+    });
 }
 
 /**
  * @brief 设置用户信息
+ *
+ * 用户列表滚动时控件会被复用，已经设置过用户时只更新显示的内容
  * @param user
  */
 void UserWidget::setUser(std::shared_ptr<User> user)
 {
+    const bool isInitialized = m_user != nullptr;
+    if (isInitialized) {
+        disconnect(m_user.get(), nullptr, this, nullptr);
+    }
     m_user = user;
 
-    initUI();
-    initConnections();
+    if (isInitialized) {
+        updateUserInfo();
+    } else {
+        initUI();
+        initConnections();
+    }
+    initUserConnections();
 
     setUid(user->uid());
     updateUserNameLabel();
 }
 
+/**
+ * @brief 更新头像、登录状态和域账户标识
+ */
+void UserWidget::updateUserInfo()
+{
+    m_avatar->setIcon(m_user->avatar());
+    m_loginState->setVisible(m_user->isLogin());
+    m_domainUserLabel->setVisible(m_user->isDomainUser());
+}
+
 const std::shared_ptr<User> &UserWidget::user() const
 {
     return m_user;
@@ -209,7 +240,7 @@ void UserWidget::updateUserNameLabel()
     if (!ok) userFrameMaxWidth = UserFrameWidth;
     int maxFontWidth = nameWidth + 25 * 2;
     int labelMaxWidth = userFrameMaxWidth - 25 * 2;
-    setFixedWidth(maxFontWidth >= userFrameMaxWidth ? userFrameMaxWidth : maxFontWidth >= UserFrameWidth ? maxFontWidth : UserFrameWidth);
+    setFixedWidth(frameWidth(nameWidth));
     if (maxFontWidth > userFrameMaxWidth) {
         QString str = m_displayNameLabel->fontMetrics().elidedText(name, Qt::ElideRight, labelMaxWidth);
         m_displayNameLabel->setText(str);
@@ -271,6 +302,15 @@ void UserWidget::resizeEvent(QResizeEvent *event)
     QWidget::resizeEvent(event);
 }
 
+void UserWidget::showEvent(QShowEvent *event)
+{
+    // 用户列表中显示出来后才获取账户的完整数据
+    if (m_user) {
+        m_user->materialize();
+    }
+    QWidget::showEvent(event);
+}
+
 int UserWidget::heightHint() const
 {
     if (m_userNameWidget)
@@ -279,6 +319,33 @@ int UserWidget::heightHint() const
     return UserFrameHeight;
 }
 
+/**
+ * @brief 计算用户控件的宽度，和 updateUserNameLabel 的结果一致，用户列表不需要创建控件就能排版
+ * @param user
+ */
+int UserWidget::widthHint(const User *user)
+{
+    const bool showUserName = DConfigHelper::instance()->getConfig(SHOW_USER_NAME, false).toBool();
+    const QString &name = showUserName ? user->name() : user->displayName();
+    const QFontMetrics metrics(DFontSizeManager::instance()->get(DFontSizeManager::T2));
+
+    return frameWidth(metrics.boundingRect(name).width());
+}
+
+/**
+ * @brief 根据名称的宽度计算控件宽度，不小于 UserFrameWidth，不超过配置的最大宽度
+ * @param nameWidth
+ */
+int UserWidget::frameWidth(int nameWidth)
+{
+    bool ok;
+    int userFrameMaxWidth = DConfigHelper::instance()->getConfig(USER_FRAME_MAX_WIDTH, UserFrameWidth).toInt(&ok);
+    if (!ok) userFrameMaxWidth = UserFrameWidth;
+    int maxFontWidth = nameWidth + 25 * 2;
+
+    return maxFontWidth >= userFrameMaxWidth ? userFrameMaxWidth : maxFontWidth >= UserFrameWidth ? maxFontWidth : UserFrameWidth;
+}
+
 void UserWidget::onDConfigPropertyChanged(const QString &key, const QVariant &value, QObject *objPtr)
 {
     auto obj = qobject_cast<UserWidget*>(objPtr);
@@ -36,6 +36,7 @@ public:
     inline uint uid() const { return m_uid; }
     void setUid(const uint uid);
     int heightHint() const;
+    static int widthHint(const User *user);
     static void onDConfigPropertyChanged(const QString &key, const QVariant &value, QObject *objPtr);
 
 signals:
@@ -47,10 +48,14 @@ protected:
     void mouseReleaseEvent(QMouseEvent *event) override;
     void paintEvent(QPaintEvent *event) override;
     void resizeEvent(QResizeEvent *event) override;
+    void showEvent(QShowEvent *event) override;
 
 private:
     void initUI();
     void initConnections();
+    void initUserConnections();
+    void updateUserInfo();
+    static int frameWidth(int nameWidth);
 
     void setAvatar(const QString &avatar);
     void updateUserNameLabel();
@@ -68,6 +73,7 @@ private:
     UserAvatar *m_avatar;                  // 用户头像
 
     DLabel *m_loginState;               // 用户登录状态
+    DLabel *m_domainUserLabel;          // 域账户标识
     DLabel *m_displayNameLabel;         // 用户全名
     QWidget *m_displayNameWidget;       // 用户全名控件
     UserNameWidget *m_userNameWidget;   // 用户名
@@ -5,25 +5,40 @@
 #include "userframelist.h"
 
 #include "dconfig_helper.h"
-#include "dflowlayout.h"
 #include "sessionbasemodel.h"
 #include "user_widget.h"
 #include "userinfo.h"
 #include "constants.h"
 
-#include <QMouseEvent>
+#include <QKeyEvent>
 #include <QScrollArea>
 #include <QScrollBar>
 #include <QScroller>
+#include <QSet>
+#include <QTimer>
 #include <QVBoxLayout>
 
+#include <algorithm>
+
 const int UserFrameSpacing = 40;
+const int UserFrameMargin = 10;
 
 using namespace DDESESSIONCC;
 
+static bool uidLessThan(const std::shared_ptr<User> &user1, const std::shared_ptr<User> &user2)
+{
+    return user1->uid() < user2->uid();
+}
+
 UserFrameList::UserFrameList(QWidget *parent)
     : QWidget(parent)
     , m_scrollArea(new QScrollArea(this))
+    , m_centerWidget(nullptr)
+    , m_model(nullptr)
+    , m_relayoutTimer(new QTimer(this))
+    , m_tileHeight(UserFrameHeight)
+    , m_selectedUid(UINT_MAX)
+    , m_isSelected(false)
 {
     setObjectName(QStringLiteral("UserFrameList"));
     setAccessibleName(QStringLiteral("UserFrameList"));
@@ -33,6 +48,13 @@ UserFrameList::UserFrameList(QWidget *parent)
 
     initUI();
 
+    // 用户名称、控件高度变化时合并到一次重新排版
+    m_relayoutTimer->setSingleShot(true);
+    m_relayoutTimer->setInterval(0);
+    connect(m_relayoutTimer, &QTimer::timeout, this, [this] {
+        updateLayout(width());
+    });
+
     // 设置用户列表支持触屏滑动,TouchGesture存在bug,滑动过程中会响应其他事件,打断滑动事件,改为LeftMouseButtonGesture
     QScroller::grabGesture(m_scrollArea->viewport(), QScroller::LeftMouseButtonGesture);
     QScroller *scroller = QScroller::scroller(m_scrollArea->viewport());
@@ -48,11 +70,6 @@ void UserFrameList::initUI()
     m_centerWidget = new QWidget;
     m_centerWidget->setAccessibleName("UserFrameListCenterWidget");
 
-    m_flowLayout = new DFlowLayout(m_centerWidget);
-    m_flowLayout->setFlow(QListView::LeftToRight);
-    m_flowLayout->setContentsMargins(10, 10, 10, 10);
-    m_flowLayout->setSpacing(40);
-
     m_scrollArea->setAccessibleName("UserFrameListCenterWidget");
     m_scrollArea->setWidget(m_centerWidget);
     m_scrollArea->setWidgetResizable(true);
@@ -64,6 +81,9 @@ void UserFrameList::initUI()
     m_scrollArea->viewport()->setAutoFillBackground(false);
     QVBoxLayout *mainLayout = new QVBoxLayout(this);
     mainLayout->addWidget(m_scrollArea, 0, Qt::AlignCenter);
+
+    // 滚动（包括触屏滑动）时回收移出可见区域的控件
+    connect(m_scrollArea->verticalScrollBar(), &QScrollBar::valueChanged, this, &UserFrameList::updateVisibleTiles);
 }
 
 //设置SessionBaseModel，创建用户列表窗体
@@ -71,17 +91,29 @@ void UserFrameList::setModel(SessionBaseModel *model)
 {
     m_model = model;
 
-    connect(model, &SessionBaseModel::userAdded, this, &UserFrameList::handlerBeforeAddUser);
-    connect(model, &SessionBaseModel::userRemoved, this, &UserFrameList::removeUser);
-    if (m_model->appType() == AppType::Login) {
-        // 处理greeter用户增删信号阻塞问题
-        connect(model, &SessionBaseModel::userListChanged, this, &UserFrameList::onUserListChanged);
-    }
+    connect(model, &SessionBaseModel::userListUpdated, this, &UserFrameList::onUserListUpdated);
 
-    QList<std::shared_ptr<User>> userList = m_model->userList();
-    for (auto user : userList) {
-        handlerBeforeAddUser(user);
+    onUserListChanged(m_model->userList());
+}
+
+/**
+ * @brief 一次处理合并后的用户增删，只重新排版一次
+ *
+ * @param diff
+ */
+void UserFrameList::onUserListUpdated(const SessionBaseModel::UserListDiff &diff)
+{
+    removeUsers(diff.removed);
+
+    QList<std::shared_ptr<User>> users;
+    for (const std::shared_ptr<User> &user : diff.added) {
+        if (acceptUser(user))
+            users.append(user);
     }
+    for (const std::shared_ptr<User> &user : diff.changed) {
+        m_tileWidths.remove(user.get());
+    }
+    addUsers(users);
 }
 
 void UserFrameList::setFixedSize(const QSize &size)
@@ -91,74 +123,135 @@ void UserFrameList::setFixedSize(const QSize &size)
     updateLayout(width());
 }
 
-void UserFrameList::handlerBeforeAddUser(std::shared_ptr<User> user)
+/**
+ * @brief 服务器版只显示已登录的用户，登录状态变化时增删
+ *
+ * @return 现在是否需要显示
+ */
+bool UserFrameList::acceptUser(const std::shared_ptr<User> &user)
+{
+    if (!m_model->isServerModel())
+        return true;
+
+    connect(user.get(), &User::loginStateChanged, this, &UserFrameList::onUserLoginStateChanged, Qt::UniqueConnection);
+    return user->isLogin() || user->type() == User::Default;
+}
+
+void UserFrameList::onUserLoginStateChanged(bool isLogin)
 {
-    if (m_model->isServerModel()) {
-        if (user->isLogin() || user->type() == User::Default)
+    User *sender = qobject_cast<User *>(this->sender());
+    const QList<std::shared_ptr<User>> userList = m_model->userList();
+    for (const std::shared_ptr<User> &user : userList) {
+        if (user.get() != sender)
+            continue;
+
+        if (isLogin) {
             addUser(user);
-        connect(user.get(), &User::loginStateChanged, this, [=](bool is_login) {
-            if (is_login) {
-                addUser(user);
-            } else {
-                removeUser(user);
-            }
-        });
-    } else {
-        addUser(user);
+        } else {
+            removeUser(user);
+        }
+        break;
     }
 }
 
-//创建用户窗体
+//添加用户
 void UserFrameList::addUser(const std::shared_ptr<User> user)
 {
-    UserWidget *widget = new UserWidget(m_centerWidget);
-    widget->setUser(user);
-    widget->setSelected(m_model->currentUser()->uid() == user->uid());
-
-    connect(widget, &UserWidget::clicked, this, &UserFrameList::onUserClicked);
+    if (m_users.contains(user))
+        return;
 
     //多用户的情况按照其uid排序，升序排列，符合账户先后创建顺序
-    m_loginWidgets.push_back(widget);
-    std::sort(m_loginWidgets.begin(), m_loginWidgets.end(), [](UserWidget *w1, UserWidget *w2) {
-        return (w1->uid() < w2->uid());
-    });
-    int index = m_loginWidgets.indexOf(widget);
-    m_flowLayout->insertWidget(index, widget);
+    m_users.insert(std::upper_bound(m_users.begin(), m_users.end(), user, uidLessThan), user);
+    connect(user.get(), &User::displayNameChanged, this, &UserFrameList::onUserInfoChanged, Qt::UniqueConnection);
+    connect(user.get(), &User::dataLoaded, this, &UserFrameList::onUserInfoChanged, Qt::UniqueConnection);
 
     //添加用户和删除用户时，重新计算区域大小
     updateLayout(width());
 }
 
+/**
+ * @brief 批量添加用户，只排序和排版一次
+ *
+ * @param users
+ */
+void UserFrameList::addUsers(const QList<std::shared_ptr<User>> &users)
+{
+    QSet<const User *> existingUsers;
+    existingUsers.reserve(m_users.size());
+    for (const std::shared_ptr<User> &user : qAsConst(m_users)) {
+        existingUsers.insert(user.get());
+    }
+
+    for (const std::shared_ptr<User> &user : users) {
+        if (existingUsers.contains(user.get()))
+            continue;
+
+        existingUsers.insert(user.get());
+        m_users.append(user);
+        connect(user.get(), &User::displayNameChanged, this, &UserFrameList::onUserInfoChanged, Qt::UniqueConnection);
+        connect(user.get(), &User::dataLoaded, this, &UserFrameList::onUserInfoChanged, Qt::UniqueConnection);
+    }
+    std::stable_sort(m_users.begin(), m_users.end(), uidLessThan);
+
+    updateLayout(width());
+}
+
 //删除用户
 void UserFrameList::removeUser(const std::shared_ptr<User> user)
 {
-    qCDebug(DDE_SHELL) << "User frame list remove user:" << user->path();
-    foreach (auto w, m_loginWidgets) {
-        if (w->uid() == user->uid()) {
-            m_loginWidgets.removeOne(w);
+    removeUsers({ user });
+}
 
-            if (w == currentSelectedUser) {
-                currentSelectedUser = nullptr;
-            }
-            w->deleteLater();
-            break;
-        }
+/**
+ * @brief 批量删除用户，只排版一次
+ *
+ * @param users
+ */
+void UserFrameList::removeUsers(const QList<std::shared_ptr<User>> &users)
+{
+    if (users.isEmpty())
+        return;
+
+    QSet<const User *> removedUsers;
+    for (const std::shared_ptr<User> &user : users) {
+        qCDebug(DDE_SHELL) << "User frame list remove user:" << user->path();
+        removedUsers.insert(user.get());
+        releaseTile(user.get());
+        m_tileWidths.remove(user.get());
+        disconnect(user.get(), &User::displayNameChanged, this, &UserFrameList::onUserInfoChanged);
+        disconnect(user.get(), &User::dataLoaded, this, &UserFrameList::onUserInfoChanged);
     }
 
+    const int count = m_users.size();
+    m_users.erase(std::remove_if(m_users.begin(), m_users.end(), [&removedUsers](const std::shared_ptr<User> &user) {
+        return removedUsers.contains(user.get());
+    }), m_users.end());
+    if (m_users.size() == count)
+        return;
+
     //添加用户和删除用户时，重新计算区域大小
     updateLayout(width());
 }
 
+/**
+ * @brief 用户名称变化后控件宽度可能变化，重新排版
+ */
+void UserFrameList::onUserInfoChanged()
+{
+    m_tileWidths.remove(qobject_cast<User *>(sender()));
+    m_relayoutTimer->start();
+}
+
 //点击用户
 void UserFrameList::onUserClicked()
 {
     UserWidget *widget = static_cast<UserWidget *>(sender());
     if (!widget) return;
 
-    currentSelectedUser = widget;
-    for (int i = 0; i != m_loginWidgets.size(); ++i) {
-        if (m_loginWidgets[i]->isSelected()) {
-            m_loginWidgets[i]->setFastSelected(false);
+    m_selectedUid = widget->uid();
+    for (UserWidget *tile : qAsConst(m_tiles)) {
+        if (tile->isSelected()) {
+            tile->setFastSelected(false);
         }
     }
     emit clicked();
@@ -170,34 +263,11 @@ void UserFrameList::onUserClicked()
  */
 void UserFrameList::switchNextUser()
 {
-    for (int i = 0; i != m_loginWidgets.size(); ++i) {
-        if (m_loginWidgets[i]->isSelected()) {
-            m_loginWidgets[i]->setSelected(false);
-            if (i == (m_loginWidgets.size() - 1)) {
-                currentSelectedUser = m_loginWidgets.first();
-                currentSelectedUser->setSelected(true);
-                //处理m_scrollArea翻页显示
-                m_scrollArea->verticalScrollBar()->setValue(0);
-            } else {
-                //处理m_scrollArea翻页显示
-                int selectedRight = m_loginWidgets[i]->geometry().right();
-                int scrollRight = m_scrollArea->widget()->geometry().right();
-                if (selectedRight + UserFrameSpacing == scrollRight) {
-                    QPoint topLeft;
-                    if (m_rowCount == 1) {
-                        topLeft = m_loginWidgets[i + 1]->geometry().topLeft();
-                    } else {
-                        topLeft = m_loginWidgets[i]->geometry().topLeft();
-                    }
-                    m_scrollArea->verticalScrollBar()->setValue(topLeft.y());
-                }
-
-                currentSelectedUser = m_loginWidgets[i + 1];
-                currentSelectedUser->setSelected(true);
-            }
-            break;
-        }
-    }
+    const int index = m_isSelected ? indexOfUid(m_selectedUid) : -1;
+    if (index < 0)
+        return;
+
+    selectIndex((index + 1) % m_users.size());
 }
 
 /**
@@ -205,53 +275,55 @@ void UserFrameList::switchNextUser()
  */
 void UserFrameList::switchPreviousUser()
 {
-    for (int i = 0; i != m_loginWidgets.size(); ++i) {
-        if (m_loginWidgets[i]->isSelected()) {
-            m_loginWidgets[i]->setSelected(false);
-            if (i == 0) {
-                currentSelectedUser = m_loginWidgets.last();
-                currentSelectedUser->setSelected(true);
-                //处理m_scrollArea翻页显示
-                m_scrollArea->verticalScrollBar()->setValue(m_scrollArea->verticalScrollBar()->maximum());
-            } else {
-                //处理m_scrollArea翻页显示
-                QPoint topLeft = m_loginWidgets[i]->geometry().topLeft();
-                if (topLeft.x() == 0) {
-                    m_scrollArea->verticalScrollBar()->setValue(m_loginWidgets[i - 1]->geometry().topLeft().y());
-                }
-
-                currentSelectedUser = m_loginWidgets[i - 1];
-                currentSelectedUser->setSelected(true);
-            }
-            break;
-        }
-    }
+    const int index = m_isSelected ? indexOfUid(m_selectedUid) : -1;
+    if (index < 0)
+        return;
+
+    selectIndex(index == 0 ? m_users.size() - 1 : index - 1);
+}
+
+/**
+ * @brief 选中用户，并滚动到用户所在的位置
+ *
+ * @param index 用户在 m_users 中的位置
+ */
+void UserFrameList::selectIndex(int index)
+{
+    m_selectedUid = m_users.at(index)->uid();
+    m_isSelected = true;
+
+    // 滚动后会更新可见区域内的控件
+    const QRect &rect = m_tileRects.at(index);
+    m_scrollArea->ensureVisible(rect.center().x(), rect.center().y(), rect.width() / 2, rect.height() / 2 + UserFrameMargin);
+    updateSelection();
 }
 
 void UserFrameList::onOtherPageChanged(const QVariant &value)
 {
-    foreach (auto w, m_loginWidgets) {
-        w->setSelected(w->uid() == value.toUInt());
-    }
+    m_selectedUid = value.toUInt();
+    m_isSelected = true;
+    updateSelection();
 }
 
 void UserFrameList::onUserListChanged(const QList<std::shared_ptr<User> > &list)
 {
-    qDeleteAll(m_loginWidgets);
-    m_loginWidgets.clear();
-    currentSelectedUser = nullptr;
+    for (const std::shared_ptr<User> &user : qAsConst(m_users)) {
+        releaseTile(user.get());
+    }
+    m_users.clear();
+    m_tileWidths.clear();
 
-    foreach(auto user, list) {
-       handlerBeforeAddUser(user);
+    QList<std::shared_ptr<User>> users;
+    for (const std::shared_ptr<User> &user : list) {
+        if (acceptUser(user))
+            users.append(user);
     }
+    addUsers(users);
 }
 
 void UserFrameList::updateLayout(int width)
 {
     // 处理窗体数量小于5个时的居中显示，取 窗体数量*窗体宽度 和 最大宽度 的较小值，设置为m_centerWidget的宽度
-    auto userWidget = m_loginWidgets.constFirst();
-    int userWidgetHeight = userWidget ? userWidget->heightHint() : UserFrameHeight;
-
     int resolutionWidth = 0;
     QWidget* parentWidget = qobject_cast<QWidget*>(this->parent());
     if (parentWidget)
@@ -260,41 +332,174 @@ void UserFrameList::updateLayout(int width)
     // 根据界面总宽度计算第一行可以显示多少用户信息
     int countWidth = 0;
     int count = 0;
-    for (auto w : m_loginWidgets) {
-        countWidth += w->width() + UserFrameSpacing;
+    for (const std::shared_ptr<User> &user : qAsConst(m_users)) {
+        const int userWidgetWidth = tileWidth(user.get());
+        countWidth += userWidgetWidth + UserFrameSpacing;
         count += 1;
         if (count > 5 || countWidth > resolutionWidth - 200 * 2) {
-            countWidth -= w->width() + UserFrameSpacing;
+            countWidth -= userWidgetWidth + UserFrameSpacing;
             count -= 1;
             break;
         }
     }
 
     if (countWidth > 0) {
-        if (m_flowLayout->count() <= count) {
-            m_scrollArea->setFixedSize(countWidth, userWidgetHeight + 20);
+        if (m_users.size() <= count) {
+            m_scrollArea->setFixedSize(countWidth, m_tileHeight + 20);
         } else {
-            m_scrollArea->setFixedSize(countWidth, (userWidgetHeight + UserFrameSpacing) * 2);
+            m_scrollArea->setFixedSize(countWidth, (m_tileHeight + UserFrameSpacing) * 2);
         }
 
         m_centerWidget->setFixedWidth(m_scrollArea->width() - 10);
     }
 
+    updateTileRects();
+    updateVisibleTiles();
+
     // 设置当前选中用户
-    std::shared_ptr<User> user = m_model->currentUser();
+    std::shared_ptr<User> user = m_model ? m_model->currentUser() : nullptr;
     if (user.get() == nullptr)
         return;
 
-    for (auto it = m_loginWidgets.constBegin(); it != m_loginWidgets.constEnd(); ++it) {
-        auto login_widget = *it;
+    m_selectedUid = user->uid();
+    m_isSelected = true;
+    updateSelection();
+}
 
-        if (login_widget->uid() == user->uid()) {
-            currentSelectedUser = login_widget;
-            currentSelectedUser->setSelected(true);
-        } else {
-            login_widget->setSelected(false);
+/**
+ * @brief 获取用户控件的宽度，按名称计算后缓存，名称变化时重新计算
+ */
+int UserFrameList::tileWidth(const User *user)
+{
+    auto it = m_tileWidths.constFind(user);
+    if (it != m_tileWidths.constEnd())
+        return it.value();
+
+    const int width = UserWidget::widthHint(user);
+    m_tileWidths.insert(user, width);
+    return width;
+}
+
+/**
+ * @brief 按从左到右、从上到下的顺序计算每个用户的位置，和之前的流式布局一致
+ */
+void UserFrameList::updateTileRects()
+{
+    const int contentWidth = m_centerWidget->width();
+    int x = UserFrameMargin;
+    int y = UserFrameMargin;
+
+    m_tileRects.resize(m_users.size());
+    for (int i = 0; i < m_users.size(); ++i) {
+        const int width = tileWidth(m_users.at(i).get());
+        if (x > UserFrameMargin && x + width > contentWidth - UserFrameMargin) {
+            x = UserFrameMargin;
+            y += m_tileHeight + UserFrameSpacing;
         }
+        m_tileRects[i] = QRect(x, y, width, m_tileHeight);
+        x += width + UserFrameSpacing;
+    }
+
+    const int contentHeight = m_tileRects.isEmpty() ? 0 : m_tileRects.last().bottom() + 1 + UserFrameMargin;
+    m_centerWidget->setFixedHeight(contentHeight);
+}
+
+/**
+ * @brief 只为可见区域及上下各一行内的用户绑定控件，其它控件回收
+ */
+void UserFrameList::updateVisibleTiles()
+{
+    const int rowHeight = m_tileHeight + UserFrameSpacing;
+    const int top = m_scrollArea->verticalScrollBar()->value() - rowHeight;
+    const int bottom = m_scrollArea->verticalScrollBar()->value() + m_scrollArea->viewport()->height() + rowHeight;
+
+    // 用户的位置按顺序从上到下，二分查找第一个可见的用户
+    const auto first = std::lower_bound(m_tileRects.cbegin(), m_tileRects.cend(), top, [](const QRect &rect, int value) {
+        return rect.bottom() < value;
+    });
+    int firstIndex = static_cast<int>(first - m_tileRects.cbegin());
+    int lastIndex = firstIndex;
+    while (lastIndex < m_tileRects.size() && m_tileRects.at(lastIndex).top() <= bottom) {
+        ++lastIndex;
     }
+
+    QHash<const User *, int> visibleUsers;
+    for (int i = firstIndex; i < lastIndex; ++i) {
+        visibleUsers.insert(m_users.at(i).get(), i);
+    }
+
+    const QList<const User *> tileUsers = m_tiles.keys();
+    for (const User *user : tileUsers) {
+        if (!visibleUsers.contains(user)) {
+            releaseTile(user);
+        }
+    }
+
+    for (int i = firstIndex; i < lastIndex; ++i) {
+        const std::shared_ptr<User> &user = m_users.at(i);
+        UserWidget *widget = m_tiles.value(user.get());
+        if (!widget) {
+            widget = takeIdleWidget();
+            widget->setUser(user);
+            m_tiles.insert(user.get(), widget);
+        }
+        widget->setSelected(m_isSelected && widget->uid() == m_selectedUid);
+        widget->move(m_tileRects.at(i).topLeft());
+        widget->show();
+
+        // 显示用户名时控件高度会变化
+        if (widget->heightHint() != m_tileHeight) {
+            m_tileHeight = widget->heightHint();
+            m_relayoutTimer->start();
+        }
+    }
+}
+
+void UserFrameList::updateSelection()
+{
+    for (UserWidget *widget : qAsConst(m_tiles)) {
+        widget->setSelected(m_isSelected && widget->uid() == m_selectedUid);
+    }
+}
+
+/**
+ * @brief 回收用户的控件，留给之后可见的用户使用
+ */
+void UserFrameList::releaseTile(const User *user)
+{
+    UserWidget *widget = m_tiles.take(user);
+    if (!widget)
+        return;
+
+    widget->hide();
+    widget->setSelected(false);
+    m_idleWidgets.append(widget);
+}
+
+UserWidget *UserFrameList::takeIdleWidget()
+{
+    if (!m_idleWidgets.isEmpty())
+        return m_idleWidgets.takeLast();
+
+    UserWidget *widget = new UserWidget(m_centerWidget);
+    connect(widget, &UserWidget::clicked, this, &UserFrameList::onUserClicked);
+    return widget;
+}
+
+/**
+ * @brief 二分查找 uid 对应的用户位置
+ *
+ * @return 没有找到时返回 -1
+ */
+int UserFrameList::indexOfUid(uint uid) const
+{
+    const auto it = std::lower_bound(m_users.cbegin(), m_users.cend(), uid, [](const std::shared_ptr<User> &user, uint value) {
+        return user->uid() < value;
+    });
+    if (it == m_users.cend() || (*it)->uid() != uid)
+        return -1;
+
+    return static_cast<int>(it - m_users.cbegin());
 }
 
 void UserFrameList::hideEvent(QHideEvent *event)
@@ -313,9 +518,9 @@ void UserFrameList::keyPressEvent(QKeyEvent *event)
         break;
     case Qt::Key_Return:
     case Qt::Key_Enter:
-        for (auto it = m_loginWidgets.constBegin(); it != m_loginWidgets.constEnd(); ++it) {
-            if ((*it)->isSelected()) {
-                emit(*it)->clicked();
+        for (auto it = m_tiles.constBegin(); it != m_tiles.constEnd(); ++it) {
+            if (it.value()->isSelected()) {
+                emit it.value()->clicked();
                 break;
             }
         }
@@ -333,16 +538,17 @@ void UserFrameList::keyPressEvent(QKeyEvent *event)
 void UserFrameList::focusInEvent(QFocusEvent *event)
 {
     Q_UNUSED(event)
-    if (currentSelectedUser != nullptr) {
-        currentSelectedUser->setSelected(true);
+    if (indexOfUid(m_selectedUid) >= 0) {
+        m_isSelected = true;
+        updateSelection();
     }
 }
 
 void UserFrameList::focusOutEvent(QFocusEvent *event)
 {
     Q_UNUSED(event)
-    if (currentSelectedUser != nullptr)
-        currentSelectedUser->setSelected(false);
+    m_isSelected = false;
+    updateSelection();
 }
 
 void UserFrameList::resizeEvent(QResizeEvent *event)
@@ -360,6 +566,7 @@ void UserFrameList::onDConfigPropertyChanged(const QString &key, const QVariant
     if (key == SHOW_USER_NAME || key == USER_FRAME_MAX_WIDTH) {
         // 需要等待UserWidget处理完，延时100ms后更新布局
         QTimer::singleShot(100, obj, [obj]{
+            obj->m_tileWidths.clear();
             obj->updateLayout(obj->width());
         });
     }
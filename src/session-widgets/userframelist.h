@@ -5,21 +5,26 @@
 #ifndef USERFRAMELIST_H
 #define USERFRAMELIST_H
 
-#include <dflowlayout.h>
+#include "sessionbasemodel.h"
 
-#include <QMap>
-#include <QPointer>
+#include <QHash>
+#include <QRect>
+#include <QVector>
+#include <QWidget>
 
 #include <memory>
 
 class UserWidget;
 class User;
-class SessionBaseModel;
-class QVBoxLayout;
 class QScrollArea;
+class QTimer;
 
-DWIDGET_USE_NAMESPACE
-
+/**
+ * @brief 用户列表
+ *
+ * 用户按 uid 升序排列，只记录每个用户的位置，只为可见区域（上下各多一行）内的用户创建控件，
+ * 滚动时移出可见区域的控件会被回收给新的用户使用，账户很多时也只有少量控件。
+ */
 class UserFrameList : public QWidget
 {
     Q_OBJECT
@@ -43,24 +48,43 @@ protected:
 
 private:
     void initUI();
-    void handlerBeforeAddUser(std::shared_ptr<User> user);
+    void onUserListUpdated(const SessionBaseModel::UserListDiff &diff);
     void addUser(const std::shared_ptr<User> user);
+    void addUsers(const QList<std::shared_ptr<User>> &users);
     void removeUser(const std::shared_ptr<User> user);
+    void removeUsers(const QList<std::shared_ptr<User>> &users);
     void onUserClicked();
     void switchNextUser();
     void switchPreviousUser();
     void onOtherPageChanged(const QVariant &value);
     void onUserListChanged(const QList<std::shared_ptr<User> > &list);
 
+    bool acceptUser(const std::shared_ptr<User> &user);
+    void onUserLoginStateChanged(bool isLogin);
+    void onUserInfoChanged();
+    int tileWidth(const User *user);
+    void updateTileRects();
+    void updateVisibleTiles();
+    void updateSelection();
+    void releaseTile(const User *user);
+    UserWidget *takeIdleWidget();
+    int indexOfUid(uint uid) const;
+    void selectIndex(int index);
+
 private:
     QScrollArea *m_scrollArea;
-    DFlowLayout *m_flowLayout;
-    QList<UserWidget *> m_loginWidgets;
-    QMap<uid_t, UserWidget *> m_userWidgets;
-    QPointer<UserWidget> currentSelectedUser;
-    SessionBaseModel *m_model;
     QWidget *m_centerWidget;
-    int m_rowCount;
+    SessionBaseModel *m_model;
+    QTimer *m_relayoutTimer;
+
+    QList<std::shared_ptr<User>> m_users;         // 按 uid 排序的用户
+    QVector<QRect> m_tileRects;                   // 每个用户在 m_centerWidget 中的位置
+    QHash<const User *, int> m_tileWidths;        // 根据名称计算的控件宽度
+    QHash<const User *, UserWidget *> m_tiles;    // 可见区域内的控件
+    QList<UserWidget *> m_idleWidgets;            // 回收的控件
+    int m_tileHeight;
+    uint m_selectedUid;                           // 当前选中的用户
+    bool m_isSelected;                            // 是否显示选中标识
 };
 
 #endif // USERFRAMELIST_H
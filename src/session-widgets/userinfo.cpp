@@ -5,10 +5,9 @@
 #include "userinfo.h"
 #include "dconfig_helper.h"
 #include "constants.h"
+#include "nss_cache.h"
 
-#include <grp.h>
 #include <memory>
-#include <pwd.h>
 
 #include "dbusconstant.h"
 
@@ -21,6 +20,7 @@ User::User(QObject *parent)
     : QObject(parent)
     , m_accountType(Administrator)
     , m_isAutomaticLogin(false)
+    , m_isLoading(false)
     , m_isLogin(false)
     , m_isNoPasswordLogin(false)
     , m_isPasswordValid(true)
@@ -45,6 +45,7 @@ User::User(const User &user)
     : QObject(user.parent())
     , m_accountType(user.m_accountType)
     , m_isAutomaticLogin(user.m_isAutomaticLogin)
+    , m_isLoading(false)
     , m_isLogin(user.m_isLogin)
     , m_isNoPasswordLogin(user.m_isNoPasswordLogin)
     , m_isPasswordValid(user.m_isPasswordValid)
@@ -86,17 +87,7 @@ bool User::operator==(const User &user) const
  */
 bool User::isLdapUser()
 {
-    struct group *grp = getgrnam("udcp");
-    if (!grp) {
-        return false;
-    }
-
-    for (char **member = grp->gr_mem; member && *member; ++member) {
-        if (*member == m_name) {
-            return true;
-        }
-    }
-    return false;
+    return NssCache::instance()->groupMembers("udcp").contains(m_name);
 }
 
 bool User::isDomainUser()
@@ -181,39 +172,7 @@ bool User::checkUserIsNoPWGrp(const User *user) const
         return false;
     }
 
-    // Caution: 32 here is unreliable, and there may be more
-    // than this number of groups that the user joins.
-
-    int ngroups = 32;
-    gid_t groups[32];
-    struct passwd *pw = nullptr;
-    struct group *gr = nullptr;
-
-    /* Fetch passwd structure (contains first group ID for user) */
-    pw = getpwnam(user->name().toUtf8().data());
-    if (pw == nullptr) {
-        qCDebug(DDE_SHELL) << "Fetch password structure failed, username: " << user->name();
-        return false;
-    }
-
-    /* Retrieve group list */
-
-    if (getgrouplist(user->name().toUtf8().data(), pw->pw_gid, groups, &ngroups) == -1) {
-        fprintf(stderr, "getgrouplist() returned -1; ngroups = %d\n",
-                ngroups);
-        return false;
-    }
-
-    /* Display list of retrieved groups, along with group names */
-
-    for (int i = 0; i < ngroups; i++) {
-        gr = getgrgid(groups[i]);
-        if (gr != nullptr && QString(gr->gr_name) == QString("nopasswdlogin")) {
-            return true;
-        }
-    }
-
-    return false;
+    return NssCache::instance()->userGroups(user->name()).contains("nopasswdlogin");
 }
 
 QString User::toLocalFile(const QString &path) const
@@ -233,21 +192,46 @@ QString User::userPwdName(const uid_t uid) const
     if (uid < 1000 && uid != 0)
         return QString();
 
-    struct passwd *pw = nullptr;
-    /* Fetch passwd structure (contains first group ID for user) */
-    pw = getpwuid(uid);
-
-    return pw ? QString().fromLocal8Bit(pw->pw_name) : QString();
+    return NssCache::instance()->passwdByUid(uid).name;
 }
 
 NativeUser::NativeUser(const QString &path, QObject *parent)
+    : NativeUser(path, LoadNow, parent)
+{
+}
+
+/**
+ * @brief 创建账户服务中的用户
+ *
+ * LoadOnDemand 时只保存 uid、用户名和路径，不创建账户服务的代理，也不获取账户属性，
+ * 用户成为当前用户或者显示在用户列表中时再调用 materialize() 获取数据，
+ * 账户较多时可以减少启动时的 D-Bus 请求和内存占用。
+ *
+ * @param path 账户服务中的用户路径
+ * @param policy 获取数据的时机
+ */
+NativeUser::NativeUser(const QString &path, LoadPolicy policy, QObject *parent)
     : User(parent)
     , m_path(path)
-    , m_userInter(new UserInter(DSS_DBUS::accountsService, path, QDBusConnection::systemBus(), this))
+    , m_userInter(nullptr)
 {
-    initConnections();
-    initData();
-    initConfiguration(DDESESSIONCC::CONFIG_FILE + m_name);
+    // 数据返回前先用路径中的 uid，按 uid 查找和排序不需要等待
+    bool ok = false;
+    const uid_t uid = path.mid(path.lastIndexOf("User") + 4).toUInt(&ok);
+    if (ok) {
+        m_uid = uid;
+    }
+
+    if (policy == LoadOnDemand) {
+        // 用户名从 passwd 中获取，按用户名查找不需要创建代理
+        const QString name = ok ? userPwdName(m_uid) : QString();
+        if (!name.isEmpty()) {
+            m_name = name;
+        }
+        return;
+    }
+
+    materialize();
 }
 
 NativeUser::NativeUser(const uid_t &uid, QObject *parent)
@@ -255,21 +239,52 @@ NativeUser::NativeUser(const uid_t &uid, QObject *parent)
     , m_path(QString(DSS_DBUS::accountsUserPath).arg(QString::number(uid)))
     , m_userInter(new UserInter(DSS_DBUS::accountsService, m_path, QDBusConnection::systemBus(), this))
 {
+    m_uid = uid;
     initConnections();
-    initData();
-    initConfiguration(DDESESSIONCC::CONFIG_FILE + m_name);
+    requestData();
 }
 
 NativeUser::NativeUser(const NativeUser &user)
     : User(user)
     , m_path(user.path())
-    , m_userInter(new UserInter(DSS_DBUS::accountsService, m_path, QDBusConnection::systemBus(), this))
+    , m_userInter(user.isStub() ? nullptr : new UserInter(DSS_DBUS::accountsService, m_path, QDBusConnection::systemBus(), this))
+{
+    // 轻量用户的拷贝仍然是轻量用户；原用户的数据还没有返回时，拷贝自己获取数据
+    if (m_userInter) {
+        initConnections();
+        if (user.isLoading()) {
+            requestData();
+        }
+    }
+}
+
+/**
+ * @brief 轻量用户创建账户服务的代理并异步获取数据，已经创建过时不做处理
+ */
+void NativeUser::materialize()
 {
+    if (m_userInter) {
+        return;
+    }
+
+    qCDebug(DDE_SHELL) << "Materialize user:" << m_path;
+    m_userInter = new UserInter(DSS_DBUS::accountsService, m_path, QDBusConnection::systemBus(), this);
     initConnections();
+    requestData();
 }
 
 void NativeUser::initConnections()
 {
+    // 用户名、uid、无密码登录（nopasswdlogin 用户组）和账户类型（用户组）变化后，NSS 缓存中的信息已经过时，
+    // 需要在更新用户信息之前清空
+    auto invalidateNssCache = [] {
+        NssCache::instance()->invalidate();
+    };
+    connect(m_userInter, &UserInter::UserNameChanged, this, invalidateNssCache);
+    connect(m_userInter, &UserInter::UidChanged, this, invalidateNssCache);
+    connect(m_userInter, &UserInter::NoPasswdLoginChanged, this, invalidateNssCache);
+    connect(m_userInter, &UserInter::AccountTypeChanged, this, invalidateNssCache);
+
     connect(m_userInter, &UserInter::AutomaticLoginChanged, this, &NativeUser::updateAutomaticLogin);
     connect(m_userInter, &UserInter::DesktopBackgroundsChanged, this, &NativeUser::updateDesktopBackgrounds);
     connect(m_userInter, &UserInter::FullNameChanged, this, &NativeUser::updateFullName);
@@ -292,43 +307,101 @@ void NativeUser::initConnections()
     connect(m_userInter, &UserInter::AccountTypeChanged, this, &NativeUser::updateAccountType);
 }
 
-void NativeUser::initData()
+/**
+ * @brief 异步获取账户的所有属性
+ *
+ * 通过一次 Properties.GetAll 获取所有属性，多个账户的请求可以同时进行，
+ * 数据返回前 isLoading() 为 true，界面显示默认的头像和名称。
+ */
+void NativeUser::requestData()
 {
-    m_isAutomaticLogin = m_userInter->automaticLogin();
-    m_isNoPasswordLogin = m_userInter->noPasswdLogin();
-    m_isPasswordValid = (m_userInter->passwordStatus() == "P");
-    m_isUse24HourFormat = m_userInter->use24HourFormat();
-    m_expiredState = m_userInter->PasswordExpiredInfo(m_expiredDayLeft).value();
-    m_shortDateFormat = m_userInter->shortDateFormat();
-    m_shortTimeFormat = m_userInter->shortTimeFormat();
-    m_weekdayFormat = m_userInter->weekdayFormat();
-    m_groups = m_userInter->groups();
-
-    const QString avatarPath = toLocalFile(m_userInter->iconFile());
-    if (!avatarPath.isEmpty() && QFile(avatarPath).exists() && QFile(avatarPath).size() && checkPictureCanRead(avatarPath)) {
-        m_avatar = avatarPath;
-    }
-    m_fullName = m_userInter->fullName();
-    const QString backgroundPath = toLocalFile(m_userInter->greeterBackground());
-    if (!backgroundPath.isEmpty() && QFile(backgroundPath).exists() && QFile(backgroundPath).size() && checkPictureCanRead(backgroundPath)) {
-        m_greeterBackground = backgroundPath;
-    }
-    m_keyboardLayout = m_userInter->layout();
-    m_locale = m_userInter->locale();
-    m_name = m_userInter->userName();
-    m_passwordHint = m_userInter->passwordHint();
-    m_desktopBackgrounds = m_userInter->desktopBackgrounds();
-    m_keyboardLayoutList = m_userInter->historyLayout();
-    m_uid = m_userInter->uid().toUInt();
-    m_accountType = m_userInter->accountType();
+    m_isLoading = true;
+
+    QDBusMessage propertiesMessage = QDBusMessage::createMethodCall(DSS_DBUS::accountsService, m_path,
+                                                                    "org.freedesktop.DBus.Properties", "GetAll");
+    propertiesMessage << m_userInter->interface();
+    m_propertiesWatcher = new QDBusPendingCallWatcher(QDBusConnection::systemBus().asyncCall(propertiesMessage), this);
+    connect(m_propertiesWatcher, &QDBusPendingCallWatcher::finished, this, &NativeUser::onPropertiesLoaded);
+
+    QDBusMessage expiredMessage = QDBusMessage::createMethodCall(DSS_DBUS::accountsService, m_path,
+                                                                 m_userInter->interface(), "PasswordExpiredInfo");
+    m_expiredInfoWatcher = new QDBusPendingCallWatcher(QDBusConnection::systemBus().asyncCall(expiredMessage), this);
+    connect(m_expiredInfoWatcher, &QDBusPendingCallWatcher::finished, this, &NativeUser::onPasswordExpiredInfoLoaded);
+}
+
+void NativeUser::onPropertiesLoaded(QDBusPendingCallWatcher *watcher)
+{
+    if (!watcher || watcher != m_propertiesWatcher) {
+        return;
+    }
+    m_propertiesWatcher = nullptr;
+    watcher->deleteLater();
+
+    QDBusPendingReply<QVariantMap> reply = *watcher;
+    if (reply.isError()) {
+        qCWarning(DDE_SHELL) << "Get user properties failed, path:" << m_path << ", error:" << reply.error().message();
+    } else {
+        applyProperties(reply.value());
+    }
+
+    initConfiguration(DDESESSIONCC::CONFIG_FILE + m_name);
+    m_isLoading = false;
+    emit dataLoaded();
+}
 
-    qCDebug(DDE_SHELL) << "Init data, user name:" << m_userInter->userName()
+void NativeUser::onPasswordExpiredInfoLoaded(QDBusPendingCallWatcher *watcher)
+{
+    if (!watcher || watcher != m_expiredInfoWatcher) {
+        return;
+    }
+    m_expiredInfoWatcher = nullptr;
+    watcher->deleteLater();
+
+    const QDBusMessage reply = watcher->reply();
+    if (reply.type() != QDBusMessage::ReplyMessage || reply.arguments().size() < 2) {
+        qCWarning(DDE_SHELL) << "Get password expired info failed, path:" << m_path << ", error:" << watcher->error().message();
+        return;
+    }
+
+    m_expiredState = reply.arguments().at(0).toInt();
+    m_expiredDayLeft = reply.arguments().at(1).toInt();
+    emit passwordExpiredInfoChanged();
+}
+
+/**
+ * @brief 应用 GetAll 返回的属性，通过各个 update 函数更新，数据有变化时发出对应的信号
+ *
+ * @param properties
+ */
+void NativeUser::applyProperties(const QVariantMap &properties)
+{
+    updateAutomaticLogin(properties.value("AutomaticLogin").toBool());
+    updateNoPasswordLogin(properties.value("NoPasswdLogin").toBool());
+    updatePasswordState(properties.value("PasswordStatus").toString());
+    updateUse24HourFormat(properties.value("Use24HourFormat").toBool());
+    updateShortDateFormat(properties.value("ShortDateFormat").toInt());
+    updateShortTimeFormat(properties.value("ShortTimeFormat").toInt());
+    updateWeekdayFormat(properties.value("WeekdayFormat").toInt());
+    m_groups = properties.value("Groups").toStringList();
+
+    updateAvatar(properties.value("IconFile").toString());
+    updateFullName(properties.value("FullName").toString());
+    updateGreeterBackground(properties.value("GreeterBackground").toString());
+    updateKeyboardLayout(properties.value("Layout").toString());
+    updateLocale(properties.value("Locale").toString());
+    updateName(properties.value("UserName").toString());
+    updatePasswordHint(properties.value("PasswordHint").toString());
+    m_desktopBackgrounds = properties.value("DesktopBackgrounds").toStringList();
+    updateKeyboardLayoutList(properties.value("HistoryLayout").toStringList());
+    updateUid(properties.value("Uid").toString());
+    m_accountType = properties.value("AccountType").toInt();
+
+    qCDebug(DDE_SHELL) << "Init data, user name:" << m_name
             << ", Is no password login:" << m_isNoPasswordLogin
             << ", Is auto login:" << m_isAutomaticLogin
             << ", Is password valid:" << m_isPasswordValid
-            << ", Password expired state:" << m_expiredState
             << ", Locale:" << m_locale
-            << ", AccountType:" << m_userInter->accountType();
+            << ", AccountType:" << m_accountType;
 }
 
 /**
@@ -361,6 +434,7 @@ void NativeUser::initConfiguration(const QString &config)
  */
 void NativeUser::setKeyboardLayout(const QString &keyboard)
 {
+    materialize();
     m_userInter->SetLayout(keyboard);
 }
 
@@ -506,6 +580,7 @@ void NativeUser::updateName(const QString &name)
         return;
     }
     m_name = name;
+    emit nameChanged(name);
     emit displayNameChanged(m_fullName.isEmpty() ? name : m_fullName);
 }
 
@@ -544,6 +619,10 @@ void NativeUser::updatePasswordHint(const QString &hint)
  */
 void NativeUser::updatePasswordExpiredInfo()
 {
+    if (!m_userInter) {
+        return;
+    }
+
     m_expiredState = m_userInter->PasswordExpiredInfo(m_expiredDayLeft).value();
     qCInfo(DDE_SHELL) << "User expired state: " << m_expiredState << ", expired day left: " << m_expiredDayLeft;
 
@@ -580,6 +659,10 @@ void NativeUser::updateUserInfo()
 
 void NativeUser::updateAccountType()
 {
+    if (!m_userInter) {
+        return;
+    }
+
     m_accountType = m_userInter->accountType();
     qCInfo(DDE_SHELL) << "User account type: " << m_accountType;
 }
@@ -653,6 +736,7 @@ void NativeUser::updateUid(const QString &uid)
         return;
     }
     m_uid = uidTmp;
+    emit uidChanged(m_uid);
 }
 
 /**
@@ -720,5 +804,6 @@ void ADDomainUser::setName(const QString &name)
         return;
     }
     m_name = name;
+    emit nameChanged(name);
     emit displayNameChanged(m_fullName.isEmpty() ? name : m_fullName);
 }
@@ -11,6 +11,9 @@
 
 #include <QObject>
 #include <QJsonObject>
+#include <QVariantMap>
+#include <QPointer>
+#include <QDBusPendingCallWatcher>
 
 #ifndef ENABLE_DSS_SNIPE
 #include <com_deepin_daemon_accounts_user.h>
@@ -60,6 +63,18 @@ public:
             obj["UnlockTime"] = unlockTime;
             return obj;
         }
+
+        inline QVariantMap toVariantMap() const
+        {
+            QVariantMap map;
+            map["Locked"] = locked;
+            map["Flag"] = flag;
+            map["MaxTries"] = static_cast<int>(maxTries);
+            map["NumFailures"] = static_cast<int>(numFailures);
+            map["UnlockSecs"] = static_cast<int>(unlockSecs);
+            map["UnlockTime"] = unlockTime;
+            return map;
+        }
     };
 
     explicit User(QObject *parent = nullptr);
@@ -74,9 +89,11 @@ public:
 
     inline bool isAutomaticLogin() const { return m_isAutomaticLogin; }
     inline bool isPasswordValid() const { return m_isPasswordValid; }
+    inline bool isLoading() const { return m_isLoading; }
     inline bool isLogin() const { return m_isLogin; }
     inline bool isNoPasswordLogin() const { return m_isNoPasswordLogin || !m_isPasswordValid; }
     virtual inline bool isUserValid() const { return false; }
+    virtual inline bool isStub() const { return false; }
     inline bool isUse24HourFormat() const { return m_isUse24HourFormat; }
 
     inline int expiredDayLeft() const { return m_expiredDayLeft; }
@@ -114,12 +131,14 @@ public:
     virtual void updatePasswordExpiredInfo() { }
     virtual void updatePasswordExpiredState(ExpiredState state, int dayLeft);
     virtual void updateUserInfo() { }
+    virtual void materialize() { }
 
 signals:
     void avatarChanged(const QString &);
     void autoLoginStateChanged(const bool);
     void desktopBackgroundChanged(const QString &);
     void displayNameChanged(const QString &);
+    void nameChanged(const QString &);
     void greeterBackgroundChanged(const QString &);
     void keyboardLayoutChanged(const QString &);
     void keyboardLayoutListChanged(const QStringList &);
@@ -133,6 +152,8 @@ signals:
     void weekdayFormatChanged(const int);
     void use24HourFormatChanged(const bool);
     void passwordExpiredInfoChanged();
+    void uidChanged(const uint);
+    void dataLoaded();
 
 
 protected:
@@ -143,6 +164,7 @@ protected:
 protected:
     int m_accountType;                   // 账户类型
     bool m_isAutomaticLogin;             // 自动登录
+    bool m_isLoading;                    // 正在从账户服务获取数据
     bool m_isLogin;                      // 登录状态
     bool m_isNoPasswordLogin;            // 无密码登录
     bool m_isPasswordValid;              // 用户是否设置密码
@@ -172,11 +194,18 @@ class NativeUser : public User
 {
     Q_OBJECT
 public:
+    enum LoadPolicy {
+        LoadNow,     // 立即创建账户服务代理并获取数据
+        LoadOnDemand // 只保存 uid、用户名和路径，需要时再获取数据
+    };
+
     explicit NativeUser(const QString &path, QObject *parent = nullptr);
+    explicit NativeUser(const QString &path, LoadPolicy policy, QObject *parent = nullptr);
     explicit NativeUser(const uid_t &uid, QObject *parent = nullptr);
     explicit NativeUser(const NativeUser &user);
 
-    inline bool isUserValid() const override { return m_userInter->isValid(); }
+    inline bool isUserValid() const override { return m_userInter && m_userInter->isValid(); }
+    inline bool isStub() const override { return !m_userInter; }
 
     inline int type() const override { return Native; }
     inline QString path() const override { return m_path; }
@@ -185,6 +214,7 @@ public:
 
     void updatePasswordExpiredInfo() override;
     virtual void updateUserInfo() override;
+    void materialize() override;
 
 private slots:
     void updateAvatar(const QString &path);
@@ -205,16 +235,21 @@ private slots:
     void updateUid(const QString &uid);
     void updateUse24HourFormat(const bool is24HourFormat);
     void updateAccountType();
+    void onPropertiesLoaded(QDBusPendingCallWatcher *watcher);
+    void onPasswordExpiredInfoLoaded(QDBusPendingCallWatcher *watcher);
 
 private:
     void initConnections();
-    void initData();
+    void requestData();
+    void applyProperties(const QVariantMap &properties);
     void initConfiguration(const QString &config);
     QStringList readDesktopBackgroundPath(const QString &path);
 
 private:
     QString m_path;
     UserInter *m_userInter;
+    QPointer<QDBusPendingCallWatcher> m_propertiesWatcher;
+    QPointer<QDBusPendingCallWatcher> m_expiredInfoWatcher;
 };
 
 class ADDomainUser : public User
@@ -4,15 +4,19 @@
 
 #include "fullscreenbackground.h"
 
+#include "backgroundhandlerThread.h"
 #include "black_widget.h"
 #include "lockcontent.h"
 #include "public_func.h"
 #include "sessionbasemodel.h"
 #include "dconfig_helper.h"
+#include "image_cache.h"
+#include "screen_geometry_provider.h"
 
 #include <DGuiApplicationHelper>
 
 #include <QDebug>
+#include <QHash>
 #include <QImageReader>
 #include <QKeyEvent>
 #include <QPainter>
@@ -26,13 +30,20 @@ Q_LOGGING_CATEGORY(DDE_SS, "dss.active")
 
 DGUI_USE_NAMESPACE
 
-const int PIXMAP_TYPE_BACKGROUND = 0;
-const int PIXMAP_TYPE_BLUR_BACKGROUND = 1;
+static const QString BLUR_BACKGROUND_CACHE_TAG = "blur-background";
+
+// 正在解码的模糊壁纸，尺寸和缩放比例相同的屏幕共用一个解码线程，不同尺寸的屏幕并行解码
+struct PendingBackground
+{
+    QPointer<BackgroundHandlerThread> thread;
+    int waiters = 0;
+};
+static QHash<QString, PendingBackground> pendingBackgrounds;
 
 QString FullScreenBackground::originBackgroundPath;
 QString FullScreenBackground::blurBackgroundPath;
+quint64 FullScreenBackground::blurPathSerial = 0;
 
-QMap<QString, QPixmap> FullScreenBackground::blurBackgroundCacheMap;
 QList<FullScreenBackground *> FullScreenBackground::frameList;
 QPointer<FullScreenBackground> FullScreenBackground::currentFrame = nullptr;
 QPointer<QWidget> FullScreenBackground::currentContent = nullptr;
@@ -43,6 +54,7 @@ FullScreenBackground::FullScreenBackground(SessionBaseModel *model, QWidget *par
     , m_useSolidBackground(false)
     , m_blackWidget(new BlackWidget(this))
     , m_resetGeometryTimer(new QTimer(this))
+    , m_blurPixmapSerial(0)
 {
 #ifndef QT_DEBUG
     if (!m_model->isUseWayland()) {
@@ -71,11 +83,17 @@ FullScreenBackground::FullScreenBackground(SessionBaseModel *model, QWidget *par
         qCDebug(DDE_SHELL) << " setGeometry : " << m_geometryRect;
         setGeometry(m_geometryRect);
     });
+    if (m_model->appType() == AuthCommon::Login && !m_model->isUseWayland()) {
+        connect(ScreenGeometryProvider::instance(), &ScreenGeometryProvider::geometriesUpdated, this, &FullScreenBackground::updateGeometry);
+    }
 }
 
 FullScreenBackground::~FullScreenBackground()
 {
     frameList.removeAll(this);
+
+    // 线程结束后会自己释放
+    releasePendingBackground();
 }
 
 void FullScreenBackground::updateBackground(const QString &path)
@@ -83,12 +101,16 @@ void FullScreenBackground::updateBackground(const QString &path)
     if (m_useSolidBackground || !isPicture(path))
         return;
 
-    if (path == originBackgroundPath && !blurBackgroundPath.isEmpty()) {
-        updateScreenBluBackground(blurBackgroundPath);
+    if (path == originBackgroundPath) {
+        // 模糊壁纸路径还在获取中时，获取完成后会刷新所有屏幕
+        if (!blurBackgroundPath.isEmpty())
+            updateScreenBluBackground(blurBackgroundPath);
         return;
     }
 
+    // 原图变化后之前的模糊壁纸路径不再有效
     originBackgroundPath = path;
+    blurBackgroundPath.clear();
     updateBlurBackground(path);
 }
 
@@ -98,41 +120,76 @@ void FullScreenBackground::updateScreenBluBackground(const QString &blurPath)
         blurBackgroundPath = blurPath;
     }
 
-    QString scaledPath;
-    if (getScaledBlurImage(blurPath, scaledPath)) {
-        QPixmap pixmap;
-        loadPixmap(scaledPath, pixmap);
-        addPixmap(pixmap, PIXMAP_TYPE_BLUR_BACKGROUND);
-    } else {
-        handleBackground(blurBackgroundPath, PIXMAP_TYPE_BLUR_BACKGROUND);
-    }
-
-    if (isVisible()) {
-        update();
-    }
+    // 模糊壁纸处理完成之前显示纯色背景或者之前的壁纸
+    requestBlurPixmap(blurBackgroundPath);
 }
 
+/**
+ * @brief 获取原图对应的模糊壁纸路径，所有屏幕共用一个请求，完成后刷新所有屏幕
+ */
 void FullScreenBackground::updateBlurBackground(const QString &path)
 {
+    const quint64 serial = ++blurPathSerial;
     QDBusMessage message = QDBusMessage::createMethodCall(DSS_DBUS::imageEffectService, DSS_DBUS::imageEffectPath,
                                                           DSS_DBUS::imageEffectService, "Get");
     message << "" << path;
-    QDBus::CallMode callMode = isVisible() ? QDBus::BlockWithGui : QDBus::Block;
-    QDBusPendingReply<QString> reply = QDBusConnection::systemBus().call(message, callMode, 2 * 1000);
-    QString blurPath;
-    if (!reply.isError()) {
-        blurPath = reply.value();
-        bool isPicture = QFile::exists(blurPath) && QFile(blurPath).size() && checkPictureCanRead(blurPath);
-        if (!isPicture) {
+    QDBusPendingCall call = QDBusConnection::systemBus().asyncCall(message, 2 * 1000);
+    // 不以当前屏幕为父对象，屏幕被移除后其它屏幕仍然需要结果
+    auto *watcher = new QDBusPendingCallWatcher(call, qApp);
+    connect(watcher, &QDBusPendingCallWatcher::finished, qApp, [serial, path](QDBusPendingCallWatcher *callWatcher) {
+        callWatcher->deleteLater();
+        if (serial != blurPathSerial || path != originBackgroundPath) {
+            qCDebug(DDE_SHELL) << "Blur background request is superseded, serial:" << serial;
+            return;
+        }
+
+        QDBusPendingReply<QString> reply = *callWatcher;
+        QString blurPath;
+        if (!reply.isError()) {
+            blurPath = reply.value();
+            if (!isPicture(blurPath)) {
+                blurPath = "/usr/share/backgrounds/default_background.jpg";
+            }
+        } else {
             blurPath = "/usr/share/backgrounds/default_background.jpg";
+            qCWarning(DDE_SHELL) << "Get blur background path error:" << reply.error().message();
         }
-    } else {
-        blurPath = "/usr/share/backgrounds/default_background.jpg";
-        qCWarning(DDE_SHELL) << "Get blur background path error:" << reply.error().message();
+
+        // 处理模糊背景图和执行动画或update；
+        blurBackgroundPath = blurPath;
+        for (FullScreenBackground *frame : frameList) {
+            if (!frame->m_useSolidBackground)
+                frame->updateScreenBluBackground(blurPath);
+        }
+    });
+}
+
+/**
+ * @brief FullScreenBackground::requestBlurPixmap
+ * 按当前尺寸获取模糊壁纸，缓存中没有时异步生成，优先使用壁纸服务缩放好的图片，否则在线程中解码缩放
+ * @param blurPath 模糊壁纸路径
+ */
+void FullScreenBackground::requestBlurPixmap(const QString &blurPath)
+{
+    releasePendingBackground();
+    const quint64 serial = ++m_blurPixmapSerial;
+    const QSize size = trueSize();
+    m_blurPixmapKey = ImageCache::cacheKey(blurPath, size, devicePixelRatioF(), BLUR_BACKGROUND_CACHE_TAG);
+
+    // 多个相同尺寸的屏幕、切换回之前的壁纸或用户时直接使用缓存
+    QPixmap pixmap;
+    if (ImageCache::instance()->find(m_blurPixmapKey, pixmap)) {
+        m_blurPixmap = pixmap;
+        if (isVisible()) {
+            update();
+        }
+        return;
     }
 
-    // 处理模糊背景图和执行动画或update；
-    updateScreenBluBackground(blurPath);
+    // 没有壁纸服务时使用自己的磁盘缓存，之后的启动不再需要解码原图
+    if (!requestScaledBlurImage(blurPath, size, serial)) {
+        handleBackground(blurPath, size, serial, true);
+    }
 }
 
 bool FullScreenBackground::contentVisible() const
@@ -237,7 +294,7 @@ void FullScreenBackground::paintEvent(QPaintEvent *e)
     if (m_useSolidBackground) {
         painter.fillRect(trueRect, QColor(DDESESSIONCC::SOLID_BACKGROUND_COLOR));
     } else {
-        const QPixmap &blurBackground = getPixmap(PIXMAP_TYPE_BLUR_BACKGROUND);
+        const QPixmap &blurBackground = m_blurPixmap;
         if (blurBackground.isNull()) {
             painter.fillRect(trueRect, QColor(DDESESSIONCC::SOLID_BACKGROUND_COLOR));
         } else {
@@ -294,19 +351,10 @@ void FullScreenBackground::leaveEvent(QEvent *event)
 
 void FullScreenBackground::resizeEvent(QResizeEvent *event)
 {
-    if (!blurBackgroundCacheMap.isEmpty() && isPicture(blurBackgroundPath) && !contains(PIXMAP_TYPE_BLUR_BACKGROUND)) {
-        QString scaledPath;
-        if (getScaledBlurImage(blurBackgroundPath, scaledPath)) {
-            QPixmap pixmap;
-            loadPixmap(scaledPath, pixmap);
-            addPixmap(pixmap, PIXMAP_TYPE_BLUR_BACKGROUND);
-        } else {
-            handleBackground(blurBackgroundPath, PIXMAP_TYPE_BLUR_BACKGROUND);
-        }
+    if (!m_useSolidBackground && m_blurPixmap.size() != trueSize() && isPicture(blurBackgroundPath)) {
+        requestBlurPixmap(blurBackgroundPath);
     }
 
-    updatePixmap();
-
     m_blackWidget->resize(size());
     if (currentFrame == this && currentContent) {
         currentContent->resize(size());
@@ -413,7 +461,14 @@ void FullScreenBackground::updateGeometry()
 
     // for bug:184943.系统修改分辨率后，登录界面获取的屏幕分辨率不正确,通过xrandr获取屏幕分辨率
     if (m_model->appType() == AuthCommon::Login && !m_model->isUseWayland()) {
-        const auto screensGeometry = getScreenGeometryByXrandr();
+        // 所有屏幕共享一次XRandR查询结果，获取到显示服务的缩放比例之前先使用qt的屏幕信息
+        ScreenGeometryProvider *provider = ScreenGeometryProvider::instance();
+        if (!provider->isReady()) {
+            setddeGeometry(m_screen->geometry());
+            return;
+        }
+
+        const auto screensGeometry = provider->geometries();
 
         if (screensGeometry.contains(m_screen->name())) {
             // 如果qt获取的屏幕分辨率和xrandr获取的屏幕分辨率一致，使用qt获取的屏幕geometry
@@ -468,80 +523,11 @@ bool FullScreenBackground::event(QEvent *e)
     return QWidget::event(e);
 }
 
-const QPixmap &FullScreenBackground::getPixmap(int type)
-{
-    static QPixmap nullPixmap;
-
-    QString strSize = sizeToString(trueSize());
-    if (PIXMAP_TYPE_BLUR_BACKGROUND == type && blurBackgroundCacheMap.contains(strSize)) {
-        return blurBackgroundCacheMap[strSize];
-    }
-
-    return nullPixmap;
-}
-
 QSize FullScreenBackground::trueSize() const
 {
     return size() * devicePixelRatioF();
 }
 
-/**
- * @brief FullScreenBackground::addPixmap
- * 新增pixmap，存在相同size的则替换，没有则新增
- * @param pixmap pixmap对象
- * @param type 清晰壁纸还是模糊壁纸
- */
-void FullScreenBackground::addPixmap(const QPixmap &pixmap, const int type)
-{
-    QString strSize = sizeToString(trueSize());
-    if (type == PIXMAP_TYPE_BLUR_BACKGROUND) {
-        blurBackgroundCacheMap[strSize] = pixmap;
-    }
-}
-
-/**
- * @brief FullScreenBackground::updatePixmap
- * 更新壁纸列表，移除当前所有屏幕都不会使用的壁纸数据
- */
-void FullScreenBackground::updatePixmap()
-{
-    auto removeNotUsedPixmap = [](QMap<QString, QPixmap> &cacheMap, const QStringList &frameSizeList) {
-        QStringList cacheMapKeys = cacheMap.keys();
-        for (auto &key : cacheMapKeys) {
-            if (!frameSizeList.contains(key)) {
-                qCInfo(DDE_SHELL) << "Remove not used pixmap:" << key;
-                cacheMap.remove(key);
-            }
-        }
-    };
-
-    QStringList frameSizeList;
-    for (auto &frame : frameList) {
-        QString strSize = sizeToString(frame->trueSize());
-        frameSizeList.append(strSize);
-    }
-
-    removeNotUsedPixmap(blurBackgroundCacheMap, frameSizeList);
-}
-
-bool FullScreenBackground::contains(int type)
-{
-    auto containPixmap = [](const QMap<QString, QPixmap> &cacheMap, const QString &strSize) {
-        if (cacheMap.contains(strSize)) {
-            const QPixmap &pixmap = cacheMap[strSize];
-            return !pixmap.isNull(); // pixmap 为空也返回false
-        } else {
-            return false;
-        }
-    };
-
-    QString strSize = sizeToString(trueSize());
-    if (PIXMAP_TYPE_BLUR_BACKGROUND == type) {
-        return containPixmap(blurBackgroundCacheMap, strSize);
-    }
-    return false;
-}
-
 void FullScreenBackground::moveEvent(QMoveEvent *event)
 {
     // 规避 bug189309，登录时后端屏幕变化通知太晚
@@ -555,76 +541,6 @@ void FullScreenBackground::moveEvent(QMoveEvent *event)
     QWidget::moveEvent(event);
 }
 
-QMap<QString, QRect> FullScreenBackground::getScreenGeometryByXrandr()
-{
-    QMap<QString, QRect> screensGeometry;
-
-    // 获取缩放比例
-    double scale = getScaleFactorFromDisplay();
-    double scaleFromDisplayQt = qApp->devicePixelRatio();
-    qCInfo(DDE_SHELL) << "Get scale factor from display scale:" << scale << " scale from display qt:" << scaleFromDisplayQt;
-    // 如果获取失败或者与从Qt获取的不一致，则不需要处理，使用Qt的屏幕信息
-    if (scale <= 0 || scaleFromDisplayQt != scale) {
-        return screensGeometry;
-    }
-
-    // 启动 xrandr | grep connected 进程
-    QProcess process;
-    QStringList arguments;
-    arguments << "-c"
-              << "xrandr | grep connected";
-    process.start("/bin/sh", arguments);
-    process.waitForStarted();
-    process.waitForFinished();
-
-    // 读取进程输出并解析屏幕信息
-    QString output = QString::fromLocal8Bit(process.readAll());
-    QRegularExpression regex("(\\S+) connected (?:primary )?(\\d+)x(\\d+)\\+(\\d+)\\+(\\d+)");
-    QRegularExpressionMatchIterator iter = regex.globalMatch(output);
-    while (iter.hasNext()) {
-        QRegularExpressionMatch match = iter.next();
-        if (match.hasMatch()) {
-            QString name = match.captured(1);
-            int width = match.captured(2).toInt();
-            int height = match.captured(3).toInt();
-            int x = match.captured(4).toInt();
-            int y = match.captured(5).toInt();
-            QRect rect(x, y, width / scale, height / scale);
-            screensGeometry.insert(name, rect);
-            qCInfo(DDE_SHELL) << "Screen name:" << name << ", screen rect:" << rect;
-        }
-    }
-
-    return screensGeometry;
-}
-
-double FullScreenBackground::getScaleFactorFromDisplay()
-{
-    QDBusInterface display(DSS_DBUS::systemDisplayService,
-                           DSS_DBUS::systemDisplayPath,
-                           DSS_DBUS::systemDisplayService,
-                           QDBusConnection::systemBus(), this);
-
-    QDBusReply<QString> reply = display.call("GetConfig");
-    QString jsonObjStr = reply.value();
-    if (jsonObjStr.isNull()) {
-        qCWarning(DDE_SHELL) << "Greeter get system display config failed (`GetConfig` null)";
-        return -1.0;
-    }
-
-    // 获取 ScaleFactors 对象
-    QJsonObject json = QJsonDocument::fromJson(jsonObjStr.toUtf8()).object();
-    QJsonObject scaleFactors = json.value("Config").toObject().value("ScaleFactors").toObject();
-
-    // 遍历 ScaleFactors 对象
-    for (const auto &key : scaleFactors.keys()) {
-        return scaleFactors.value(key).toDouble();
-    }
-
-    qCWarning(DDE_SHELL) << "greeter get system display config failed(`scaleFactors` null)";
-    return -1.0;
-}
-
 void FullScreenBackground::updateCurrentFrame(FullScreenBackground *frame)
 {
     if (!frame) {
@@ -639,30 +555,91 @@ void FullScreenBackground::updateCurrentFrame(FullScreenBackground *frame)
     setContent(currentContent);
 }
 
-void FullScreenBackground::handleBackground(const QString &path, int type)
-{
-    QSize trueSize = this->trueSize();
+/**
+ * @brief FullScreenBackground::handleBackground
+ * 在线程中解码和缩放壁纸，完成后再转换为QPixmap加入缓存。
+ * 其它屏幕正在解码相同的图片时直接等待它的结果
+ * @param path 壁纸路径
+ * @param size 目标尺寸（物理像素）
+ * @param serial 请求序号
+ * @param useDiskCache 是否使用缩放壁纸的磁盘缓存
+ */
+void FullScreenBackground::handleBackground(const QString &path, const QSize &size, quint64 serial, bool useDiskCache)
+{
+    releasePendingBackground();
+
+    const QString key = m_blurPixmapKey;
+    PendingBackground &pending = pendingBackgrounds[key];
+    if (!pending.thread) {
+        BackgroundHandlerThread *thread = new BackgroundHandlerThread;
+        thread->setBackgroundInfo(path, size, devicePixelRatioF());
+        thread->setUseDiskCache(useDiskCache);
+        connect(thread, &QThread::finished, qApp, [key, thread] {
+            auto it = pendingBackgrounds.find(key);
+            if (it != pendingBackgrounds.end() && it->thread == thread) {
+                pendingBackgrounds.erase(it);
+            }
+        });
+        connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+        pending.thread = thread;
+        thread->start();
+    }
+    pending.waiters++;
+    m_pendingBackgroundKey = key;
 
-    QPixmap pixmap;
-    loadPixmap(path, pixmap);
+    auto onBackgroundHandled = [this, serial](const QImage &image) {
+        if (serial != m_blurPixmapSerial || image.isNull()) {
+            return;
+        }
 
-    pixmap = pixmap.scaled(trueSize, Qt::KeepAspectRatioByExpanding, Qt::FastTransformation);
-    pixmap = pixmap.copy(QRect((pixmap.width() - trueSize.width()) / 2,
-                               (pixmap.height() - trueSize.height()) / 2,
-                               trueSize.width(),
-                               trueSize.height()));
+        releasePendingBackground();
+        QPixmap pixmap;
+        if (!ImageCache::instance()->find(m_blurPixmapKey, pixmap)) {
+            pixmap = QPixmap::fromImage(image);
+            ImageCache::instance()->insert(m_blurPixmapKey, pixmap);
+        }
+        m_blurPixmap = pixmap;
+        if (isVisible()) {
+            update();
+        }
+    };
+    connect(pending.thread, &BackgroundHandlerThread::backgroundHandled, this, onBackgroundHandled);
 
-    // draw pix to widget, so pix need set pixel ratio from qwidget devicepixelratioF
-    pixmap.setDevicePixelRatio(devicePixelRatioF());
-    addPixmap(pixmap, type);
+    // 共用的线程可能已经发出了结果
+    QImage image;
+    if (pending.thread->result(image)) {
+        onBackgroundHandled(image);
+    }
 }
 
-QString FullScreenBackground::sizeToString(const QSize &size)
+/**
+ * @brief FullScreenBackground::releasePendingBackground
+ * 不再等待之前的解码结果，没有屏幕等待时中断解码线程
+ */
+void FullScreenBackground::releasePendingBackground()
 {
-    return QString("%1x%2").arg(size.width()).arg(size.height());
+    if (m_pendingBackgroundKey.isEmpty()) {
+        return;
+    }
+
+    auto it = pendingBackgrounds.find(m_pendingBackgroundKey);
+    m_pendingBackgroundKey.clear();
+    if (it == pendingBackgrounds.end() || --it->waiters > 0) {
+        return;
+    }
+
+    if (it->thread) {
+        it->thread->requestInterruption();
+    }
+    pendingBackgrounds.erase(it);
 }
 
-bool FullScreenBackground::getScaledBlurImage(const QString &originPath, QString &scaledPath)
+/**
+ * @brief FullScreenBackground::requestScaledBlurImage
+ * 异步向壁纸服务请求缩放好的图片，拿到后在线程中解码
+ * @return 是否已经发起请求，壁纸服务不存在时返回false
+ */
+bool FullScreenBackground::requestScaledBlurImage(const QString &originPath, const QSize &size, quint64 serial)
 {
     // 为了兼容没有安装壁纸服务环境;Qt5.15高版本可以使用activatableServiceNames()遍历然后可判断系统有没有安装服务
     const QString wallpaperServicePath = "/lib/systemd/system/dde-wallpaper-cache.service";
@@ -671,10 +648,6 @@ bool FullScreenBackground::getScaledBlurImage(const QString &originPath, QString
         return false;
     }
 
-    // 壁纸服务dde-wallpaper-cache
-    QDBusInterface wallpaperCacheInterface("org.deepin.dde.WallpaperCache", "/org/deepin/dde/WallpaperCache",
-                                           "org.deepin.dde.WallpaperCache", QDBusConnection::systemBus());
-
     QFile file(originPath);
     if (!file.open(QIODevice::ReadOnly)) {
         qWarning() << "Failed to open file.";
@@ -686,28 +659,36 @@ bool FullScreenBackground::getScaledBlurImage(const QString &originPath, QString
         return false;
     }
 
-    QDBusUnixFileDescriptor dbusFd(fd);
+    // 壁纸服务dde-wallpaper-cache，直接构造消息，避免QDBusInterface同步内省
+    QDBusMessage message = QDBusMessage::createMethodCall("org.deepin.dde.WallpaperCache", "/org/deepin/dde/WallpaperCache",
+                                                          "org.deepin.dde.WallpaperCache", "GetProcessedImagePathByFd");
     const QString &pathmd5 = QCryptographicHash::hash(originPath.toUtf8(), QCryptographicHash::Md5).toHex();
     QVariantList sizeArray;
-    sizeArray << QVariant::fromValue(this->trueSize());
-    QDBusReply<QStringList> pathList = wallpaperCacheInterface.call("GetProcessedImagePathByFd", QVariant::fromValue(dbusFd), pathmd5, sizeArray);
-    if (pathList.value().isEmpty()) {
-        qWarning() << "GetProcessedImagePathByFd interface return null";
-        return false;
-    }
+    sizeArray << QVariant::fromValue(size);
+    message << QVariant::fromValue(QDBusUnixFileDescriptor(fd)) << pathmd5 << QVariant(sizeArray);
+
+    QDBusPendingCall call = QDBusConnection::systemBus().asyncCall(message);
+    auto *watcher = new QDBusPendingCallWatcher(call, this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, originPath, size, serial](QDBusPendingCallWatcher *callWatcher) {
+        callWatcher->deleteLater();
+        if (serial != m_blurPixmapSerial) {
+            return;
+        }
 
-    QString path = pathList.value().at(0);
-    if (!path.isEmpty() && path != originPath) {
-        scaledPath = path;
+        QDBusPendingReply<QStringList> reply = *callWatcher;
+        const QString path = reply.isError() || reply.value().isEmpty() ? QString() : reply.value().at(0);
         // 图片处理完之后会添加_xxxx尺寸后缀，升级场景第一次登录只能获取到正在处理的原生图片，此时不能进行设置
-        if (!path.contains("_")) {
-            return false;
+        if (path.isEmpty() || path == originPath || !path.contains("_")) {
+            qWarning() << "GetProcessedImagePathByFd return invalid path:" << path;
+            handleBackground(originPath, size, serial);
+            return;
         }
+
         qDebug() << "get scaled path:" << path;
-        return true;
-    }
+        handleBackground(path, size, serial);
+    });
 
-    return false;
+    return true;
 }
 
 //增加一个定时器，每隔50ms再设置一次Geometry，避免出现xorg初始化未完成的情况，导致界面显示不全
@@ -18,6 +18,7 @@ Q_DECLARE_LOGGING_CATEGORY(DDE_SS)
 
 class BlackWidget;
 class SessionBaseModel;
+class BackgroundHandlerThread;
 class FullScreenBackground : public QWidget, public AbstractFullBackgroundInterface
 {
     Q_OBJECT
@@ -60,18 +61,13 @@ private:
     void mouseMoveEvent(QMouseEvent *event) Q_DECL_OVERRIDE;
     void updateScreen(QPointer<QScreen> screen);
     void updateGeometry();
-    bool isPicture(const QString &file);
+    static bool isPicture(const QString &file);
     QString getLocalFile(const QString &file);
-    const QPixmap& getPixmap(int type);
     QSize trueSize() const;
-    void addPixmap(const QPixmap &pixmap, const int type);
-    static void updatePixmap();
-    bool contains(int type);
     void tryActiveWindow(int count = 9);
-    QMap<QString, QRect> getScreenGeometryByXrandr();
-    double getScaleFactorFromDisplay();
     static void updateCurrentFrame(FullScreenBackground *frame);
-    bool getScaledBlurImage(const QString &originPath, QString &scaledPath);
+    void requestBlurPixmap(const QString &blurPath);
+    bool requestScaledBlurImage(const QString &originPath, const QSize &size, quint64 serial);
     void setddeGeometry(const QRect &rect);
     void updateScreenBluBackground(const QString &path);
 
@@ -80,13 +76,14 @@ protected:
     static QList<FullScreenBackground *> frameList;
     static QPointer<FullScreenBackground> currentFrame;
 
-    void handleBackground(const QString &path, int type);
-    static QString sizeToString(const QSize &size);
+    void handleBackground(const QString &path, const QSize &size, quint64 serial, bool useDiskCache = false);
+    void releasePendingBackground();
 
 private:
     static QString originBackgroundPath; // 原图路径
-    static QString blurBackgroundPath; // 模糊背景图片路径
-    static QMap<QString, QPixmap> blurBackgroundCacheMap;
+    static QString blurBackgroundPath; // 原图对应的模糊背景图片路径，获取完成之前为空
+    // 异步获取模糊壁纸路径，所有屏幕共用，序号变化说明有更新的请求，旧请求的结果直接丢弃
+    static quint64 blurPathSerial;
 
     QPointer<QScreen> m_screen;
     SessionBaseModel *m_model = nullptr;
@@ -96,6 +93,12 @@ private:
     BlackWidget *m_blackWidget;
     QTimer *m_resetGeometryTimer;
     QRect m_geometryRect;
+
+    // 异步获取模糊壁纸，序号变化说明有更新的请求，旧请求的结果直接丢弃
+    quint64 m_blurPixmapSerial;
+    QString m_blurPixmapKey;
+    QPixmap m_blurPixmap;
+    QString m_pendingBackgroundKey;
 };
 
 #endif // FULLSCREENBACKGROUND_H
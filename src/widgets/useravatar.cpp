@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "useravatar.h"
+#include "image_cache.h"
 
 #include <QUrl>
 #include <QFile>
@@ -41,33 +42,33 @@ void UserAvatar::setIcon(const QString &iconPath)
     } else {
         m_iconPath = iconPath;
     }
+
+    // 头像只在用户头像变化（User::avatarChanged）后重新设置，此时重新生成
+    m_avatarPixmap = QPixmap();
+    update();
 }
 
 void UserAvatar::paintEvent(QPaintEvent *)
 {
     QPainter painter(this);
     QRect roundedRect((width() - m_avatarSize) / 2, (height() - m_avatarSize) / 2, m_avatarSize, m_avatarSize);
-    QPainterPath path;
-    path.addRoundedRect(roundedRect, AVATAR_ROUND_RADIUS, AVATAR_ROUND_RADIUS);
 
     painter.setRenderHint(QPainter::Antialiasing);
     painter.setRenderHint(QPainter::SmoothPixmapTransform);
-    painter.setClipPath(path);
-
-    const auto ratio = devicePixelRatioF();
-    QString imgPath = m_iconPath;
-    if (ratio > 1.0)
-        imgPath.replace("icons/", "icons/bigger/");
-    if (!QFile(imgPath).exists())
-        imgPath = m_iconPath;
 
-    QImage tmpImg(imgPath);
-
-    painter.drawImage(roundedRect, this->isEnabled() ? tmpImg : imageToGray(tmpImg));
+    // 重绘时直接使用已经处理好的圆角头像，尺寸、缩放比例或者启用状态变化时才重新生成
+    const qreal ratio = devicePixelRatioF();
+    if (m_avatarPixmap.isNull() || m_avatarPixmapSize != roundedRect.size()
+            || !qFuzzyCompare(m_avatarPixmapRatio, ratio) || m_avatarPixmapEnabled != isEnabled()) {
+        updateAvatarPixmap(roundedRect.size(), ratio);
+    }
+    painter.drawPixmap(roundedRect.topLeft(), m_avatarPixmap);
 
     QColor penColor = m_selected ? m_borderSelectedColor : m_borderColor;
 
     if (m_borderWidth) {
+        QPainterPath path;
+        path.addRoundedRect(roundedRect, AVATAR_ROUND_RADIUS, AVATAR_ROUND_RADIUS);
         QPen pen;
         pen.setColor(penColor);
         pen.setWidth(m_borderWidth);
@@ -77,6 +78,55 @@ void UserAvatar::paintEvent(QPaintEvent *)
     }
 }
 
+/**
+ * @brief 生成圆角头像
+ *
+ * 解码、缩放、灰度和圆角处理后的头像放到共享缓存中，显示同一个用户的控件共用一份
+ * @param size 头像尺寸（逻辑像素）
+ * @param ratio 缩放比例
+ */
+void UserAvatar::updateAvatarPixmap(const QSize &size, qreal ratio)
+{
+    m_avatarPixmapSize = size;
+    m_avatarPixmapRatio = ratio;
+    m_avatarPixmapEnabled = isEnabled();
+
+    QString imgPath = m_iconPath;
+    if (ratio > 1.0)
+        imgPath.replace("icons/", "icons/bigger/");
+    if (!QFile(imgPath).exists())
+        imgPath = m_iconPath;
+
+    const QSize imageSize = size * ratio;
+    const QString cacheKey = ImageCache::cacheKey(imgPath, imageSize, ratio, m_avatarPixmapEnabled ? "avatar" : "avatar-gray");
+    if (ImageCache::instance()->find(cacheKey, m_avatarPixmap)) {
+        return;
+    }
+
+    QImage tmpImg(imgPath);
+    if (!tmpImg.isNull()) {
+        tmpImg = tmpImg.scaled(imageSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        if (!m_avatarPixmapEnabled) {
+            tmpImg = imageToGray(tmpImg);
+        }
+    }
+
+    // 用图片作为画刷绘制圆角矩形，边缘有抗锯齿，重绘时不再需要裁剪
+    QPixmap avatar(imageSize);
+    avatar.fill(Qt::transparent);
+    if (!tmpImg.isNull()) {
+        QPainter painter(&avatar);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(QBrush(tmpImg));
+        painter.drawRoundedRect(QRectF(QPointF(0, 0), imageSize), AVATAR_ROUND_RADIUS * ratio, AVATAR_ROUND_RADIUS * ratio);
+    }
+    avatar.setDevicePixelRatio(ratio);
+
+    m_avatarPixmap = avatar;
+    ImageCache::instance()->insert(cacheKey, m_avatarPixmap);
+}
+
 QImage UserAvatar::imageToGray(const QImage &image)
 {
     int height = image.height();
@@ -69,6 +69,7 @@ protected:
 private:
     QImage imageToGray(const QImage &image);
     void initDeleteButton();
+    void updateAvatarPixmap(const QSize &size, qreal ratio);
 
     QLabel *m_iconLabel = nullptr;
     QString m_iconPath = "";
@@ -79,6 +80,12 @@ private:
     bool m_selected = false;
     bool m_deleteable = false;
 
+    // 处理好的圆角头像及生成时的状态
+    QPixmap m_avatarPixmap;
+    QSize m_avatarPixmapSize;
+    qreal m_avatarPixmapRatio = 1.0;
+    bool m_avatarPixmapEnabled = true;
+
     const int SMALL_ICON_SIZE = 80;
     const int NORMAL_ICON_SIZE = 90;
     const int LARGE_ICON_SIZE = 100;
@@ -5,8 +5,43 @@
 #include "authcommon.h"
 #include "deepinauthframework.h"
 
+#include <QElapsedTimer>
+#include <QThread>
+
+#include <security/pam_appl.h>
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+
 #include <gtest/gtest.h>
 
+namespace {
+
+/**
+ * @brief 模拟一个只询问一次密码的 PAM 模块，返回 pam_authenticate 的结果
+ */
+int stubPamAuthenticate(DeepinAuthFramework *framework, const PAMAuthJobPtr &job, const char *expectedToken, std::atomic_bool *prompted)
+{
+    pam_message message = {PAM_PROMPT_ECHO_OFF, "Password: "};
+    const pam_message *messages[] = {&message};
+    pam_response *response = nullptr;
+    DeepinAuthFramework::PAMConversationContext context = {framework, job.get()};
+
+    *prompted = true;
+    const int ret = DeepinAuthFramework::PAMConversation(1, messages, &response, &context);
+    if (ret != PAM_SUCCESS) {
+        return ret;
+    }
+
+    const bool matched = response[0].resp && strcmp(response[0].resp, expectedToken) == 0;
+    free(response[0].resp);
+    free(response);
+    return matched ? PAM_SUCCESS : PAM_AUTH_ERR;
+}
+
+} // namespace
+
 class UT_DeepinAuthFramework : public testing::Test
 {
 protected:
@@ -33,6 +68,76 @@ TEST_F(UT_DeepinAuthFramework, PAMTest)
 //    m_authFramework->DestroyAuthenticate();
 }
 
+TEST_F(UT_DeepinAuthFramework, PAMTokenLatencyBenchmark)
+{
+    DeepinAuthFramework framework;
+    const int rounds = 5;
+    qint64 totalNs = 0;
+    qint64 maxNs = 0;
+
+    for (int i = 0; i < rounds; ++i) {
+        std::atomic_bool prompted(false);
+        QElapsedTimer timer;
+        std::atomic<qint64> elapsedNs(0);
+        int ret = PAM_SYSTEM_ERR;
+        PAMAuthJobPtr job = std::make_shared<PAMAuthJob>(i + 1, "uos");
+        framework.m_PAMAuthJob = job;
+
+        std::thread worker([&] {
+            ret = stubPamAuthenticate(&framework, job, "123", &prompted);
+            elapsedNs = timer.nsecsElapsed();
+        });
+        while (!prompted) {
+            QThread::msleep(1);
+        }
+        // 保证 PAM 线程已经进入等待
+        QThread::msleep(20);
+
+        timer.start();
+        framework.SendToken("123");
+        worker.join();
+
+        job->setFinished();
+        EXPECT_EQ(ret, PAM_SUCCESS);
+        totalNs += elapsedNs;
+        maxNs = qMax(maxNs, qint64(elapsedNs));
+    }
+
+    qInfo() << "PAM token to authenticate return, average(us):" << totalNs / rounds / 1000
+            << ", max(us):" << maxNs / 1000;
+    // 旧的 sleep(1) 轮询最多会带来 1s 的延迟
+    EXPECT_LT(maxNs, 100 * 1000 * 1000);
+}
+
+TEST_F(UT_DeepinAuthFramework, PAMCancelWakesConversation)
+{
+    DeepinAuthFramework framework;
+    std::atomic_bool prompted(false);
+    QElapsedTimer timer;
+    std::atomic<qint64> elapsedNs(0);
+    int ret = PAM_SUCCESS;
+    PAMAuthJobPtr job = std::make_shared<PAMAuthJob>(1, "uos");
+    framework.m_PAMAuthJob = job;
+
+    std::thread worker([&] {
+        ret = stubPamAuthenticate(&framework, job, "123", &prompted);
+        elapsedNs = timer.nsecsElapsed();
+    });
+    while (!prompted) {
+        QThread::msleep(1);
+    }
+    QThread::msleep(20);
+
+    timer.start();
+    framework.DestroyAuthenticate();
+    worker.join();
+
+    EXPECT_EQ(ret, PAM_ABORT);
+    EXPECT_TRUE(job->isCancelled());
+    EXPECT_FALSE(framework.IsUsingPamAuth());
+    EXPECT_LT(qint64(elapsedNs), 100 * 1000 * 1000);
+}
+
 TEST_F(UT_DeepinAuthFramework, DATest)
 {
 //    const QString UserName("uos");
@@ -3,8 +3,10 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "fullscreenbackground.h"
+#include "image_cache.h"
 #include "sessionbasemodel.h"
 
+#include <QTemporaryDir>
 #include <QTest>
 
 #include <gtest/gtest.h>
@@ -45,3 +47,34 @@ TEST_F(UT_FullscreenBackground, BasicTest)
     m_background->updateBlurBackground("/usr/share/backgrounds/default_background.jpg");
     QTest::keyPress(m_background, Qt::Key_0, Qt::KeyboardModifier::NoModifier);
 }
+
+TEST_F(UT_FullscreenBackground, SharedBackgroundDecode)
+{
+    QTemporaryDir dir;
+    const QString path = dir.filePath("wallpaper.png");
+    QImage source(64, 48, QImage::Format_ARGB32);
+    source.fill(Qt::red);
+    ASSERT_TRUE(source.save(path));
+
+    FullScreenBackground other(m_model);
+    const QSize size(32, 24);
+    m_background->resize(size);
+    other.resize(size);
+    ImageCache::instance()->clear();
+
+    // 相同尺寸的屏幕只启动一个解码线程
+    m_background->m_blurPixmapKey = ImageCache::cacheKey(path, size, m_background->devicePixelRatioF(), "blur-background");
+    other.m_blurPixmapKey = m_background->m_blurPixmapKey;
+    m_background->handleBackground(path, size, m_background->m_blurPixmapSerial);
+    other.handleBackground(path, size, other.m_blurPixmapSerial);
+    EXPECT_EQ(m_background->m_pendingBackgroundKey, other.m_pendingBackgroundKey);
+
+    for (int i = 0; i < 100 && (m_background->m_blurPixmap.isNull() || other.m_blurPixmap.isNull()); ++i) {
+        QTest::qWait(20);
+    }
+    ASSERT_FALSE(m_background->m_blurPixmap.isNull());
+    ASSERT_FALSE(other.m_blurPixmap.isNull());
+    EXPECT_EQ(m_background->m_blurPixmap.cacheKey(), other.m_blurPixmap.cacheKey());
+    EXPECT_TRUE(m_background->m_pendingBackgroundKey.isEmpty());
+    EXPECT_TRUE(other.m_pendingBackgroundKey.isEmpty());
+}
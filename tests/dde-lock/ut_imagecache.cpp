@@ -0,0 +1,83 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "image_cache.h"
+
+#include <QTemporaryDir>
+
+#include <gtest/gtest.h>
+
+class UT_ImageCache : public testing::Test
+{
+protected:
+    void SetUp() override;
+    void TearDown() override;
+
+    ImageCache *m_cache;
+};
+
+void UT_ImageCache::SetUp()
+{
+    m_cache = new ImageCache;
+}
+
+void UT_ImageCache::TearDown()
+{
+    delete m_cache;
+}
+
+TEST_F(UT_ImageCache, KeyContainsSizeAndRatio)
+{
+    const QString path("/usr/share/backgrounds/default_background.jpg");
+    EXPECT_NE(ImageCache::cacheKey(path, QSize(1920, 1080), 1.0), ImageCache::cacheKey(path, QSize(1920, 1080), 2.0));
+    EXPECT_NE(ImageCache::cacheKey(path, QSize(1920, 1080), 1.0), ImageCache::cacheKey(path, QSize(1280, 1024), 1.0));
+    EXPECT_NE(ImageCache::cacheKey(path, QSize(1920, 1080), 1.0), ImageCache::cacheKey("/tmp/other.jpg", QSize(1920, 1080), 1.0));
+    EXPECT_NE(ImageCache::cacheKey(path, QSize(90, 90), 1.0, "avatar"), ImageCache::cacheKey(path, QSize(90, 90), 1.0, "avatar-gray"));
+}
+
+TEST_F(UT_ImageCache, HitAndMiss)
+{
+    QPixmap pixmap(100, 100);
+    pixmap.fill(Qt::red);
+
+    QPixmap result;
+    EXPECT_FALSE(m_cache->find("key", result));
+    m_cache->insert("key", pixmap);
+    EXPECT_TRUE(m_cache->find("key", result));
+    EXPECT_EQ(result.size(), pixmap.size());
+    EXPECT_EQ(m_cache->hitCount(), 1u);
+    EXPECT_EQ(m_cache->missCount(), 1u);
+}
+
+TEST_F(UT_ImageCache, EvictByBudget)
+{
+    QPixmap pixmap(256, 256);
+    pixmap.fill(Qt::red);
+    const qint64 bytes = static_cast<qint64>(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+    m_cache->setByteBudget(bytes * 2);
+
+    m_cache->insert("first", pixmap);
+    m_cache->insert("second", pixmap);
+    QPixmap result;
+    // 访问first，second成为最久未使用的
+    EXPECT_TRUE(m_cache->find("first", result));
+    m_cache->insert("third", pixmap);
+
+    EXPECT_TRUE(m_cache->find("first", result));
+    EXPECT_FALSE(m_cache->find("second", result));
+    EXPECT_TRUE(m_cache->find("third", result));
+    EXPECT_LE(m_cache->usedBytes(), m_cache->byteBudget());
+}
+
+TEST_F(UT_ImageCache, RemoveByPath)
+{
+    QPixmap pixmap(10, 10);
+    pixmap.fill(Qt::red);
+    const QString key = ImageCache::cacheKey("/tmp/a.jpg", QSize(10, 10), 1.0);
+    m_cache->insert(key, pixmap);
+    m_cache->removeByPath("/tmp/a.jpg");
+
+    QPixmap result;
+    EXPECT_FALSE(m_cache->find(key, result));
+}
@@ -4,8 +4,16 @@
 
 #include "keyboardplantform_wayland.h"
 
+#include <QList>
+
 #include <gtest/gtest.h>
 
+#include <memory>
+
+// X11 的头文件定义了很多宏，需要放在最后
+#include <X11/XKBlib.h>
+#include <X11/Xlib.h>
+
 #ifdef USE_DEEPIN_WAYLAND
 class UT_KeyboardPlantformWayland : public testing::Test
 {
@@ -32,4 +40,40 @@ TEST_F(UT_KeyboardPlantformWayland, basic)
     m_keyboard->isNumLockOn();
     m_keyboard->setNumLockStatus(false);
 }
+
+/**
+ * @brief 断开抓取时会临时修改一个空闲键码的映射，结束后键盘映射应和之前完全一致
+ */
+TEST_F(UT_KeyboardPlantformWayland, ungrabKeyboardRestoresKeyMap)
+{
+    std::unique_ptr<Display, int (*)(Display *)> display(XOpenDisplay(nullptr), XCloseDisplay);
+    if (!display) {
+        // 没有 X 服务时无法断开抓取，只验证不会阻塞或崩溃
+        m_keyboard->ungrabKeyboard();
+        return;
+    }
+
+    auto keySyms = [&display] {
+        QList<QList<KeySym>> result;
+        XkbDescPtr xkb = XkbGetMap(display.get(), XkbKeySymsMask, XkbUseCoreKbd);
+        if (!xkb)
+            return result;
+
+        for (int code = xkb->min_key_code; code <= xkb->max_key_code; ++code) {
+            QList<KeySym> syms;
+            for (int i = 0; i < XkbKeyNumSyms(xkb, code); ++i)
+                syms << XkbKeySymsPtr(xkb, code)[i];
+            result << syms;
+        }
+        XkbFreeKeyboard(xkb, 0, True);
+        return result;
+    };
+
+    const QList<QList<KeySym>> before = keySyms();
+    ASSERT_FALSE(before.isEmpty());
+
+    m_keyboard->ungrabKeyboard();
+
+    EXPECT_EQ(before, keySyms());
+}
 #endif
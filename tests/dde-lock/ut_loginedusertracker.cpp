@@ -0,0 +1,159 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logined_user_tracker.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <list>
+#include <random>
+
+class UT_LoginedUserTracker : public testing::Test
+{
+protected:
+    void SetUp() override;
+    void TearDown() override;
+
+    static QString userListJson(const QMap<uint, QStringList> &displays);
+
+    LoginedUserTracker *m_tracker;
+};
+
+void UT_LoginedUserTracker::SetUp()
+{
+    m_tracker = new LoginedUserTracker;
+}
+
+void UT_LoginedUserTracker::TearDown()
+{
+    delete m_tracker;
+}
+
+/**
+ * @brief 按 Logined.UserList 的格式生成 json
+ */
+QString UT_LoginedUserTracker::userListJson(const QMap<uint, QStringList> &displays)
+{
+    QJsonObject userList;
+    for (auto it = displays.constBegin(); it != displays.constEnd(); ++it) {
+        QJsonArray sessions;
+        for (const QString &display : it.value()) {
+            QJsonObject session;
+            session["Uid"] = static_cast<int>(it.key());
+            session["Display"] = display;
+            session["Desktop"] = "deepin";
+            sessions.append(session);
+        }
+        userList[QString::number(it.key())] = sessions;
+    }
+
+    return QString::fromUtf8(QJsonDocument(userList).toJson(QJsonDocument::Compact));
+}
+
+TEST_F(UT_LoginedUserTracker, Diff)
+{
+    LoginedUserTracker::Diff diff;
+    ASSERT_TRUE(m_tracker->update(userListJson({ { 1000, { ":0" } }, { 1001, { ":1" } } }), diff));
+    EXPECT_EQ(diff.loggedIn.size(), 2);
+    EXPECT_TRUE(m_tracker->hasDisplay(1000));
+
+    ASSERT_TRUE(m_tracker->update(userListJson({ { 1000, { ":0", ":2" } } }), diff));
+    EXPECT_EQ(diff.loggedIn, QList<uint>());
+    EXPECT_EQ(diff.changed, QList<uint>({ 1000 }));
+    EXPECT_EQ(diff.loggedOut, QList<uint>({ 1001 }));
+    EXPECT_FALSE(m_tracker->contains(1001));
+
+    // 数据没有变化
+    ASSERT_TRUE(m_tracker->update(userListJson({ { 1000, { ":0", ":2" } } }), diff));
+    EXPECT_TRUE(diff.isEmpty());
+
+    // 无效数据不影响之前的结果
+    EXPECT_FALSE(m_tracker->update("{", diff));
+    EXPECT_TRUE(m_tracker->contains(1000));
+
+    // 没有显示的会话是系统服务
+    ASSERT_TRUE(m_tracker->update("{\"0\":[{\"Display\":\"\",\"Desktop\":\"\"}]}", diff));
+    EXPECT_TRUE(m_tracker->contains(0));
+    EXPECT_FALSE(m_tracker->hasDisplay(0));
+    EXPECT_FALSE(m_tracker->hasDesktop(0));
+}
+
+TEST_F(UT_LoginedUserTracker, ReplayBenchmark)
+{
+    // 模拟终端服务器上的登录、注销事件，记录每次变化后的 Logined.UserList
+    const int userCount = 60;
+    const int eventCount = 3000;
+    std::mt19937 generator(20260101);
+    std::uniform_int_distribution<int> userDistribution(0, userCount - 1);
+    QMap<uint, QStringList> displays;
+    QStringList records;
+    int expectedLogin = 0;
+    int expectedLogout = 0;
+    int expectedChanged = 0;
+    for (int i = 0; i < eventCount; ++i) {
+        const uint uid = static_cast<uint>(1000 + userDistribution(generator));
+        QStringList &userDisplays = displays[uid];
+        if (userDisplays.size() < 3 && (userDisplays.isEmpty() || generator() % 2)) {
+            userDisplays.append(QString(":%1").arg(10 + i));
+            userDisplays.size() == 1 ? ++expectedLogin : ++expectedChanged;
+        } else {
+            userDisplays.removeFirst();
+            userDisplays.isEmpty() ? ++expectedLogout : ++expectedChanged;
+        }
+        if (userDisplays.isEmpty()) {
+            displays.remove(uid);
+        }
+        records.append(userListJson(displays));
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    int login = 0;
+    int logout = 0;
+    int changed = 0;
+    for (const QString &record : qAsConst(records)) {
+        LoginedUserTracker::Diff diff;
+        ASSERT_TRUE(m_tracker->update(record, diff));
+        login += diff.loggedIn.size();
+        logout += diff.loggedOut.size();
+        changed += diff.changed.size();
+    }
+    const qint64 trackerNs = timer.nsecsElapsed();
+
+    // 每个事件只产生一个变化
+    EXPECT_EQ(login, expectedLogin);
+    EXPECT_EQ(logout, expectedLogout);
+    EXPECT_EQ(changed, expectedChanged);
+    EXPECT_EQ(m_tracker->uids().size(), displays.size());
+
+    // 之前的实现：每次重新生成已登录列表，再对每个用户线性查找
+    QList<uint> allUids;
+    for (int i = 0; i < userCount; ++i) {
+        allUids.append(static_cast<uint>(1000 + i));
+    }
+    timer.restart();
+    int loginedCount = 0;
+    for (const QString &record : qAsConst(records)) {
+        std::list<uint> loginUserList;
+        const QJsonObject userList = QJsonDocument::fromJson(record.toUtf8()).object();
+        for (auto it = userList.constBegin(); it != userList.constEnd(); ++it) {
+            loginUserList.push_back(it.key().toUInt());
+        }
+        for (const uint uid : qAsConst(allUids)) {
+            loginedCount += std::any_of(loginUserList.begin(), loginUserList.end(), [uid](const uint UID) { return UID == uid; });
+        }
+    }
+    const qint64 fullNs = timer.nsecsElapsed();
+
+    qInfo() << "Replay" << eventCount << "login/logout events, tracker(us):" << trackerNs / 1000
+            << ", full rebuild(us):" << fullNs / 1000 << ", logined checks:" << loginedCount;
+}
@@ -0,0 +1,137 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "login_plugin_v2.h"
+#include "login_plugin_v3.h"
+#include "public_func.h"
+
+#include <QElapsedTimer>
+#include <QJsonDocument>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+// 两个版本的插件处理相同的消息，只是接口不同
+QVariantMap handleMessage(const QVariantMap &message)
+{
+    QVariantMap data;
+    const QString cmdType = message.value("CmdType").toString();
+    if (cmdType == "GetLevel") {
+        data["Level"] = 2;
+    } else if (cmdType == "AuthState") {
+        data["AuthState"] = message.value("Data").toMap().value("AuthState");
+    }
+
+    QVariantMap result;
+    result["Code"] = 0;
+    result["Message"] = "Success";
+    result["Data"] = data;
+    return result;
+}
+
+class FakeLoginModuleV2 : public dss::module_v2::LoginModuleInterfaceV2
+{
+public:
+    void init() override {}
+    QString key() const override { return "fake-login-v2"; }
+    QWidget *content() override { return nullptr; }
+    void setAuthCallback(dss::module_v2::AuthCallbackFun) override {}
+    void reset() override {}
+
+    QString message(const QString &message) override
+    {
+        const QJsonDocument doc = QJsonDocument::fromJson(message.toUtf8());
+        return toJson(QJsonObject::fromVariantMap(handleMessage(doc.object().toVariantMap())));
+    }
+};
+
+class FakeLoginModuleV3 : public dss::module_v3::LoginModuleInterfaceV3
+{
+public:
+    void init() override {}
+    QString key() const override { return "fake-login-v3"; }
+    QWidget *content() override { return nullptr; }
+    void setAuthCallback(dss::module_v2::AuthCallbackFun) override {}
+    void reset() override {}
+
+    using dss::module_v3::LoginModuleInterfaceV3::message;
+    QVariantMap message(const QVariantMap &message) override { return handleMessage(message); }
+};
+
+QVariantMap authStateMessage(int state)
+{
+    QVariantMap data;
+    data["AuthType"] = 1;
+    data["AuthState"] = state;
+    QVariantMap message;
+    message["CmdType"] = "AuthState";
+    message["Data"] = data;
+    return message;
+}
+
+}
+
+class UT_LoginPluginV3 : public testing::Test
+{
+protected:
+    void SetUp() override;
+    void TearDown() override;
+
+    FakeLoginModuleV2 *m_moduleV2;
+    FakeLoginModuleV3 *m_moduleV3;
+    LoginPlugin_V2::LoginPluginV2 *m_pluginV2;
+    LoginPlugin_V3::LoginPluginV3 *m_pluginV3;
+};
+
+void UT_LoginPluginV3::SetUp()
+{
+    m_moduleV2 = new FakeLoginModuleV2;
+    m_moduleV3 = new FakeLoginModuleV3;
+    m_pluginV2 = new LoginPlugin_V2::LoginPluginV2(m_moduleV2);
+    m_pluginV3 = new LoginPlugin_V3::LoginPluginV3(m_moduleV3);
+}
+
+void UT_LoginPluginV3::TearDown()
+{
+    delete m_pluginV2;
+    delete m_pluginV3;
+    delete m_moduleV2;
+    delete m_moduleV3;
+}
+
+TEST_F(UT_LoginPluginV3, JsonAdapter)
+{
+    const QVariantMap message = authStateMessage(3);
+    EXPECT_EQ(LoginPlugin_V2::fromJsonMessage(LoginPlugin_V2::toJsonMessage(message)), QJsonObject::fromVariantMap(message).toVariantMap());
+    EXPECT_TRUE(LoginPlugin_V2::fromJsonMessage("invalid").isEmpty());
+
+    // 两种接口的结果相同
+    EXPECT_EQ(m_pluginV2->level(), 2);
+    EXPECT_EQ(m_pluginV3->level(), 2);
+    EXPECT_EQ(m_pluginV2->message(message).value("Data").toMap().value("AuthState").toInt(), 3);
+    EXPECT_EQ(m_pluginV3->message(message).value("Data").toMap().value("AuthState").toInt(), 3);
+}
+
+TEST_F(UT_LoginPluginV3, StructuredNotSlowerThanJson)
+{
+    const int count = 10000;
+    const QVariantMap message = authStateMessage(0);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < count; ++i) {
+        m_pluginV2->message(message);
+    }
+    const qint64 jsonElapsed = timer.nsecsElapsed();
+
+    timer.restart();
+    for (int i = 0; i < count; ++i) {
+        m_pluginV3->message(message);
+    }
+    const qint64 structuredElapsed = timer.nsecsElapsed();
+
+    // 结构化消息省去了序列化和解析，留出余量避免机器负载波动导致误报
+    EXPECT_LE(structuredElapsed, jsonElapsed * 3 / 2);
+}
@@ -4,10 +4,20 @@
 
 #include "multiscreenmanager.h"
 
+#include <QElapsedTimer>
 #include <QGuiApplication>
 
 #include <gtest/gtest.h>
 
+// 模拟启动时还没有屏幕，之后屏幕才接入的场景
+class DelayedScreenManager : public MultiScreenManager
+{
+public:
+    QList<QScreen *> screens() const override { return m_screens; }
+
+    QList<QScreen *> m_screens;
+};
+
 class UT_MultiScreenManager : public testing::Test
 {
 protected:
@@ -33,3 +43,34 @@ TEST_F(UT_MultiScreenManager, basic)
     m_manager->register_for_multi_screen(nullptr);
     m_manager->onScreenRemoved(QGuiApplication::primaryScreen());
 }
+
+TEST_F(UT_MultiScreenManager, DelayedScreenArrival)
+{
+    DelayedScreenManager manager;
+    int createdCount = 0;
+    QList<QWidget *> frames;
+    auto createFrame = [&](QScreen *, int) -> QWidget * {
+        createdCount++;
+        QWidget *w = new QWidget;
+        frames.append(w);
+        return w;
+    };
+
+    // 没有屏幕时立即返回，不阻塞事件循环
+    QElapsedTimer timer;
+    timer.start();
+    manager.register_for_multi_screen(createFrame);
+    EXPECT_LT(timer.elapsed(), 1000);
+    EXPECT_EQ(createdCount, 0);
+    EXPECT_TRUE(manager.m_screenWatchdogTimer->isActive());
+
+    // 屏幕接入后创建窗口并停止看门狗
+    QScreen *screen = QGuiApplication::primaryScreen();
+    ASSERT_TRUE(screen);
+    manager.m_screens.append(screen);
+    manager.onScreenAdded(screen);
+    EXPECT_EQ(createdCount, 1);
+    EXPECT_FALSE(manager.m_screenWatchdogTimer->isActive());
+
+    qDeleteAll(frames);
+}
@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "nss_cache.h"
+
+#include <QSignalSpy>
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+class UT_NssCache : public testing::Test
+{
+protected:
+    void SetUp() override;
+    void TearDown() override;
+
+    NssCache *m_cache;
+};
+
+void UT_NssCache::SetUp()
+{
+    m_cache = new NssCache;
+}
+
+void UT_NssCache::TearDown()
+{
+    delete m_cache;
+}
+
+TEST_F(UT_NssCache, Passwd)
+{
+    const NssCache::Passwd root = m_cache->passwdByUid(0);
+    ASSERT_TRUE(root.valid);
+    EXPECT_EQ(root.name, QString("root"));
+
+    // 按 uid 查询后按用户名查询直接命中缓存
+    ASSERT_EQ(m_cache->m_passwdByName.size(), 1);
+    EXPECT_EQ(m_cache->passwdByName("root").uid, 0u);
+
+    EXPECT_FALSE(m_cache->passwdByName("dde-session-shell-no-such-user").valid);
+    EXPECT_TRUE(m_cache->userGroups("dde-session-shell-no-such-user").isEmpty());
+}
+
+TEST_F(UT_NssCache, UserGroups)
+{
+    const NssCache::Passwd current = m_cache->passwdByUid(getuid());
+    ASSERT_TRUE(current.valid);
+
+    const QStringList groups = m_cache->userGroups(current.name);
+    EXPECT_FALSE(groups.isEmpty());
+    EXPECT_EQ(m_cache->m_groupNames.size(), groups.size());
+}
+
+TEST_F(UT_NssCache, TimeToLive)
+{
+    m_cache->passwdByUid(0);
+    EXPECT_TRUE(m_cache->m_passwdByUid.contains(0));
+
+    // 过期后重新查询
+    m_cache->setTimeToLive(0);
+    m_cache->invalidate();
+    m_cache->passwdByUid(0);
+    EXPECT_TRUE(m_cache->m_passwdByUid.isEmpty());
+}
+
+TEST_F(UT_NssCache, Invalidate)
+{
+    m_cache->passwdByUid(0);
+    m_cache->userGroups("root");
+    EXPECT_FALSE(m_cache->m_passwdByName.isEmpty());
+    EXPECT_FALSE(m_cache->m_userGroups.isEmpty());
+
+    // 账户服务通知用户变化后清空
+    m_cache->invalidate();
+    EXPECT_TRUE(m_cache->m_passwdByName.isEmpty());
+    EXPECT_TRUE(m_cache->m_passwdByUid.isEmpty());
+    EXPECT_TRUE(m_cache->m_userGroups.isEmpty());
+    EXPECT_TRUE(m_cache->m_groupNames.isEmpty());
+}
+
+TEST_F(UT_NssCache, Prefetch)
+{
+    QSignalSpy spy(m_cache, &NssCache::prefetched);
+    m_cache->prefetch(QStringList() << "root");
+    ASSERT_TRUE(spy.wait(5000));
+    EXPECT_TRUE(m_cache->m_passwdByName.contains("root"));
+    EXPECT_TRUE(m_cache->m_userGroups.contains("root"));
+    EXPECT_TRUE(m_cache->m_prefetchThreads.isEmpty());
+}
@@ -0,0 +1,111 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "pam_auth_worker.h"
+
+#include <QElapsedTimer>
+#include <QThread>
+
+#include <atomic>
+#include <mutex>
+#include <set>
+
+#include <gtest/gtest.h>
+
+TEST(UT_PAMAuthWorker, ReuseThread)
+{
+    std::mutex mutex;
+    std::set<std::thread::id> threadIds;
+    std::atomic_int handled(0);
+
+    PAMAuthWorker worker([&](const PAMAuthJobPtr &) {
+        std::lock_guard<std::mutex> locker(mutex);
+        threadIds.insert(std::this_thread::get_id());
+        ++handled;
+    }, 1);
+
+    for (int i = 0; i < 20; ++i) {
+        PAMAuthJobPtr job = worker.submit("uos");
+        while (!job->isFinished()) {
+            QThread::msleep(1);
+        }
+    }
+
+    EXPECT_EQ(handled, 20);
+    EXPECT_EQ(threadIds.size(), 1u);
+}
+
+TEST(UT_PAMAuthWorker, CooperativeCancel)
+{
+    std::atomic_int handled(0);
+    PAMAuthWorker worker([&](const PAMAuthJobPtr &job) {
+        QString token;
+        if (job->waitForToken(token)) {
+            ++handled;
+        }
+    }, 1);
+
+    PAMAuthJobPtr first = worker.submit("uos");
+    PAMAuthJobPtr second = worker.submit("test");
+    EXPECT_NE(first->id(), second->id());
+
+    // 第二个任务还在排队，取消后不应被执行
+    second->cancel();
+    first->cancel();
+    while (!first->isFinished()) {
+        QThread::msleep(1);
+    }
+
+    PAMAuthJobPtr third = worker.submit("uos");
+    EXPECT_TRUE(third->sendToken("123"));
+    while (!third->isFinished()) {
+        QThread::msleep(1);
+    }
+
+    EXPECT_TRUE(second->isCancelled());
+    EXPECT_EQ(handled, 1);
+}
+
+TEST(UT_PAMAuthWorker, ReplaceStuckThread)
+{
+    // 模拟阻塞在 pam_authenticate 中、不响应取消的模块
+    auto released = std::make_shared<std::atomic_bool>(false);
+    auto handled = std::make_shared<std::atomic_int>(0);
+    auto *worker = new PAMAuthWorker([released, handled](const PAMAuthJobPtr &job) {
+        if (job->account() == "stuck") {
+            while (!*released) {
+                QThread::msleep(1);
+            }
+            return;
+        }
+        ++*handled;
+    }, 1, 50);
+
+    PAMAuthJobPtr stuck = worker->submit("stuck");
+    QThread::msleep(10);
+    stuck->cancel();
+
+    PAMAuthJobPtr next = worker->submit("uos");
+    QThread::msleep(20);
+    EXPECT_FALSE(next->isFinished());
+
+    // 取消超时后线程池自行补充线程，新任务不再排队
+    for (int i = 0; i < 100 && !next->isFinished(); ++i) {
+        QThread::msleep(10);
+    }
+    EXPECT_TRUE(next->isFinished());
+    EXPECT_EQ(*handled, 1);
+
+    // 析构不等待卡住的线程
+    QElapsedTimer timer;
+    timer.start();
+    delete worker;
+    EXPECT_LT(timer.elapsed(), 50);
+
+    *released = true;
+    for (int i = 0; i < 100 && !stuck->isFinished(); ++i) {
+        QThread::msleep(10);
+    }
+    EXPECT_TRUE(stuck->isFinished());
+}
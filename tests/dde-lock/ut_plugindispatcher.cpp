@@ -0,0 +1,131 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "login_plugin_v3.h"
+#include "plugin_dispatcher.h"
+
+#include <QAtomicInt>
+#include <QStringList>
+#include <QThread>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+class SlowLoginModule : public dss::module_v3::LoginModuleInterfaceV3
+{
+public:
+    void init() override {}
+    QString key() const override { return "slow-login"; }
+    QWidget *content() override { return nullptr; }
+    void setAuthCallback(dss::module_v2::AuthCallbackFun) override {}
+    void reset() override {}
+
+    using dss::module_v3::LoginModuleInterfaceV3::message;
+    QVariantMap message(const QVariantMap &message) override
+    {
+        if (message.value("CmdType").toString() == "Slow")
+            QThread::msleep(10);
+        m_lastThread = QThread::currentThread();
+        m_lastMessage = message;
+        m_history.append(message.value("CmdType").toString());
+        m_received.fetchAndAddOrdered(1);
+        return {{"Code", 0}};
+    }
+
+    QAtomicInt m_received;
+    QThread *m_lastThread = nullptr;
+    QVariantMap m_lastMessage;
+    QStringList m_history;
+};
+
+}
+
+class UT_PluginDispatcher : public testing::Test
+{
+protected:
+    void SetUp() override;
+    void TearDown() override;
+
+    PluginDispatcher *m_dispatcher;
+    SlowLoginModule *m_module;
+    LoginPlugin_V3::LoginPluginV3 *m_plugin;
+};
+
+void UT_PluginDispatcher::SetUp()
+{
+    m_dispatcher = new PluginDispatcher;
+    m_dispatcher->setBudget(5);
+    m_module = new SlowLoginModule;
+    m_plugin = new LoginPlugin_V3::LoginPluginV3(m_module);
+}
+
+void UT_PluginDispatcher::TearDown()
+{
+    m_dispatcher->forget(m_plugin->key());
+    delete m_dispatcher;
+    delete m_plugin;
+    delete m_module;
+}
+
+TEST_F(UT_PluginDispatcher, DemoteSlowPlugin)
+{
+    const QString key = m_plugin->key();
+    m_dispatcher->call(m_plugin, {{"CmdType", "Fast"}});
+    EXPECT_EQ(m_dispatcher->stats(key).calls, 1u);
+    EXPECT_EQ(m_dispatcher->stats(key).slowCalls, 0u);
+
+    for (int i = 0; i < 3; ++i) {
+        m_dispatcher->call(m_plugin, {{"CmdType", "Slow"}});
+    }
+    EXPECT_EQ(m_dispatcher->stats(key).slowCalls, 3u);
+    EXPECT_TRUE(m_dispatcher->isDemoted(key));
+
+    // 降级后状态通知暂存，同类只保留最新的一条，在下一条其它消息之前补发
+    const int received = m_module->m_received;
+    m_dispatcher->notify(m_plugin, {{"CmdType", "AuthFactorsChanged"}, {"Data", 1}});
+    m_dispatcher->notify(m_plugin, {{"CmdType", "LimitsInfo"}, {"Data", 2}});
+    m_dispatcher->notify(m_plugin, {{"CmdType", "AuthFactorsChanged"}, {"Data", 3}});
+    EXPECT_EQ(int(m_module->m_received), received);
+    EXPECT_EQ(m_dispatcher->pendingCount(key), 2);
+
+    m_module->m_history.clear();
+    m_dispatcher->notify(m_plugin, {{"CmdType", "AuthState"}, {"Data", 4}});
+    EXPECT_EQ(int(m_module->m_received), received + 3);
+    EXPECT_EQ(m_module->m_history, QStringList({"LimitsInfo", "AuthFactorsChanged", "AuthState"}));
+    EXPECT_EQ(m_module->m_lastMessage.value("Data").toInt(), 4);
+    EXPECT_EQ(m_dispatcher->pendingCount(key), 0);
+
+    // 连续多次在预算内返回后恢复
+    for (int i = 0; i < 10; ++i) {
+        m_dispatcher->call(m_plugin, {{"CmdType", "Fast"}});
+    }
+    EXPECT_FALSE(m_dispatcher->isDemoted(key));
+}
+
+TEST_F(UT_PluginDispatcher, ThreadSafePlugin)
+{
+    m_plugin->setThreadSafe(true);
+    m_dispatcher->notify(m_plugin, {{"CmdType", "Slow"}});
+
+    for (int i = 0; i < 100 && m_module->m_received == 0; ++i) {
+        QThread::msleep(10);
+    }
+    EXPECT_EQ(int(m_module->m_received), 1);
+    EXPECT_NE(m_module->m_lastThread, QThread::currentThread());
+    EXPECT_EQ(m_dispatcher->stats(m_plugin->key()).calls, 1u);
+}
+
+TEST_F(UT_PluginDispatcher, ThreadSafePluginOrder)
+{
+    // 等待时间和预算相同，预算要大于通知的耗时
+    m_dispatcher->setBudget(1000);
+    m_plugin->setThreadSafe(true);
+    m_dispatcher->notify(m_plugin, {{"CmdType", "Slow"}, {"Data", 1}});
+
+    // 同步调用在之前的通知之后处理
+    m_dispatcher->call(m_plugin, {{"CmdType", "Fast"}, {"Data", 2}});
+    EXPECT_EQ(int(m_module->m_received), 2);
+    EXPECT_EQ(m_module->m_lastMessage.value("Data").toInt(), 2);
+}
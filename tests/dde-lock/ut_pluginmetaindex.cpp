@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "plugin_meta_index.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <gtest/gtest.h>
+
+class UT_PluginMetaIndex : public testing::Test
+{
+protected:
+    void SetUp() override;
+    void TearDown() override;
+
+    QTemporaryDir *m_dir;
+};
+
+void UT_PluginMetaIndex::SetUp()
+{
+    m_dir = new QTemporaryDir;
+}
+
+void UT_PluginMetaIndex::TearDown()
+{
+    delete m_dir;
+}
+
+TEST_F(UT_PluginMetaIndex, SaveAndLoad)
+{
+    ASSERT_TRUE(m_dir->isValid());
+
+    const QString pluginFile = m_dir->filePath("libtest-plugin.so");
+    QFile file(pluginFile);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write("plugin");
+    file.close();
+
+    const QString cacheFile = m_dir->filePath("cache/index.cache");
+    PluginMetaIndex index(cacheFile);
+    EXPECT_FALSE(index.load());
+
+    PluginMetaIndex::Entry entry;
+    entry.api = "2.0.0";
+    entry.pluginType = "Login";
+    entry.threadSafe = true;
+    index.insert(QFileInfo(pluginFile), entry);
+    index.setKey(QFileInfo(pluginFile), "test-plugin");
+    EXPECT_TRUE(index.isDirty());
+    ASSERT_TRUE(index.save());
+    EXPECT_FALSE(index.isDirty());
+
+    PluginMetaIndex loaded(cacheFile);
+    ASSERT_TRUE(loaded.load());
+    PluginMetaIndex::Entry loadedEntry;
+    ASSERT_TRUE(loaded.find(QFileInfo(pluginFile), loadedEntry));
+    EXPECT_EQ(loadedEntry.api, QString("2.0.0"));
+    EXPECT_EQ(loadedEntry.pluginType, QString("Login"));
+    EXPECT_EQ(loadedEntry.key, QString("test-plugin"));
+    EXPECT_TRUE(loadedEntry.threadSafe);
+
+    // 插件文件更新后记录失效
+    ASSERT_TRUE(file.open(QIODevice::Append));
+    file.write("updated");
+    file.close();
+    EXPECT_FALSE(loaded.find(QFileInfo(pluginFile), loadedEntry));
+
+    // 插件删除后移除记录
+    loaded.retain(QSet<QString>());
+    EXPECT_EQ(loaded.size(), 0);
+    EXPECT_TRUE(loaded.isDirty());
+}
@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "screen_geometry_provider.h"
+
+#include <QSignalSpy>
+
+#include <gtest/gtest.h>
+
+class UT_ScreenGeometryProvider : public testing::Test
+{
+protected:
+    void SetUp() override;
+    void TearDown() override;
+
+    ScreenGeometryProvider *m_provider;
+};
+
+void UT_ScreenGeometryProvider::SetUp()
+{
+    m_provider = new ScreenGeometryProvider;
+}
+
+void UT_ScreenGeometryProvider::TearDown()
+{
+    delete m_provider;
+}
+
+TEST_F(UT_ScreenGeometryProvider, ScaleFactorFromConfig)
+{
+    EXPECT_LT(ScreenGeometryProvider::scaleFactorFromConfig(QString()), 0);
+    EXPECT_LT(ScreenGeometryProvider::scaleFactorFromConfig("{\"Config\":{}}"), 0);
+    EXPECT_DOUBLE_EQ(ScreenGeometryProvider::scaleFactorFromConfig("{\"Config\":{\"ScaleFactors\":{\"eDP-1\":1.25}}}"), 1.25);
+}
+
+TEST_F(UT_ScreenGeometryProvider, ConfigUpdated)
+{
+    QSignalSpy spy(m_provider, &ScreenGeometryProvider::geometriesUpdated);
+    m_provider->onDisplayConfigUpdated("{\"Config\":{\"ScaleFactors\":{\"eDP-1\":2}}}");
+    EXPECT_TRUE(m_provider->isReady());
+    EXPECT_EQ(spy.count(), 1);
+
+    // 缩放比例没有变化时不重复通知
+    m_provider->onDisplayConfigUpdated("{\"Config\":{\"ScaleFactors\":{\"eDP-1\":2}}}");
+    EXPECT_EQ(spy.count(), 1);
+
+    // 结果在下一次屏幕变化前一直复用
+    m_provider->geometries();
+    EXPECT_FALSE(m_provider->m_dirty);
+    m_provider->invalidate();
+    EXPECT_TRUE(m_provider->m_dirty);
+}
@@ -135,3 +135,80 @@ TEST_F(UT_SessionBaseModel, init)
     m_sessionBaseModel->setHasVirtualKB(true);
     m_sessionBaseModel->setHasVirtualKB(false);
 }
+
+TEST_F(UT_SessionBaseModel, LazyUserList)
+{
+    const int count = 50;
+    QStringList paths;
+    for (int i = 0; i < count; ++i) {
+        paths.append(QString(DSS_DBUS::accountsUserPath).arg(QString::number(20000 + i)));
+    }
+
+    // 用户列表中只创建轻量用户，按路径排序
+    m_sessionBaseModel->updateUserList(paths);
+    const QList<std::shared_ptr<User>> users = m_sessionBaseModel->userList();
+    ASSERT_EQ(users.size(), count);
+    for (int i = 0; i < count; ++i) {
+        EXPECT_EQ(users.at(i)->uid(), static_cast<uint>(20000 + i));
+        EXPECT_TRUE(users.at(i)->isStub());
+    }
+
+    // 按用户名、uid 查找不会创建账户服务的代理
+    EXPECT_TRUE(m_sessionBaseModel->findUserByUid(20001)->isStub());
+
+    // 成为当前用户时只创建这一个用户的代理，数据异步返回
+    std::shared_ptr<User> user = m_sessionBaseModel->findUserByUid(20000);
+    ASSERT_TRUE(user);
+    m_sessionBaseModel->updateCurrentUser(user);
+    EXPECT_EQ(m_sessionBaseModel->currentUser(), user);
+
+    int materializedCount = 0;
+    for (const std::shared_ptr<User> &u : m_sessionBaseModel->userList()) {
+        if (!u->isStub()) {
+            ++materializedCount;
+        }
+    }
+    EXPECT_EQ(materializedCount, 1);
+    EXPECT_FALSE(user->isStub());
+}
+
+TEST_F(UT_SessionBaseModel, CoalescedUserListUpdate)
+{
+    int updateCount = 0;
+    int listChangedCount = 0;
+    SessionBaseModel::UserListDiff lastDiff;
+    QObject::connect(m_sessionBaseModel, &SessionBaseModel::userListUpdated, m_sessionBaseModel, [&](const SessionBaseModel::UserListDiff &diff) {
+        ++updateCount;
+        lastDiff = diff;
+    });
+    QObject::connect(m_sessionBaseModel, &SessionBaseModel::userListChanged, m_sessionBaseModel, [&] {
+        ++listChangedCount;
+    });
+
+    // 批量更新只通知一次，批量中增加又删除的用户不通知
+    QList<std::shared_ptr<User>> users;
+    m_sessionBaseModel->beginUserListUpdate();
+    for (int i = 0; i < 100; ++i) {
+        std::shared_ptr<User> user(new ADDomainUser(static_cast<uint>(30000 + i)));
+        users.append(user);
+        m_sessionBaseModel->addUser(user);
+    }
+    m_sessionBaseModel->removeUser(users.first());
+    m_sessionBaseModel->commitUserListUpdate();
+    EXPECT_EQ(updateCount, 1);
+    EXPECT_EQ(listChangedCount, 1);
+    EXPECT_EQ(lastDiff.added.size(), 99);
+    EXPECT_TRUE(lastDiff.removed.isEmpty());
+
+    // 批量更新之外的变化合并到下一次事件循环
+    m_sessionBaseModel->removeUser(users.at(1));
+    m_sessionBaseModel->removeUser(users.at(2));
+    users.at(3)->updateLoginState(true);
+    EXPECT_EQ(updateCount, 1);
+    QCoreApplication::processEvents();
+    EXPECT_EQ(updateCount, 2);
+    EXPECT_EQ(listChangedCount, 2);
+    EXPECT_EQ(lastDiff.removed.size(), 2);
+    EXPECT_EQ(lastDiff.changed.size(), 1);
+    EXPECT_TRUE(lastDiff.added.isEmpty());
+}
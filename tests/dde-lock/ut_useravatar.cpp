@@ -3,8 +3,10 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "useravatar.h"
+#include "image_cache.h"
 
 #include <QPaintEvent>
+#include <QTemporaryDir>
 
 #include <gtest/gtest.h>
 
@@ -42,3 +44,36 @@ TEST_F(UT_UserAvatar, BasicTest)
     m_avatar->setColor(QColor());
     //m_avatar->paintEvent(new QPaintEvent(m_avatar->rect()));
 }
+
+TEST_F(UT_UserAvatar, SharedAvatarPixmap)
+{
+    QTemporaryDir dir;
+    const QString path = dir.filePath("avatar.png");
+    QImage source(200, 200, QImage::Format_ARGB32);
+    source.fill(Qt::green);
+    ASSERT_TRUE(source.save(path));
+
+    ImageCache::instance()->clear();
+    UserAvatar other;
+    m_avatar->setIcon(path);
+    other.setIcon(path);
+    m_avatar->grab();
+    other.grab();
+
+    // 显示同一个头像的控件共用一份处理好的图片，重绘时不再重新生成
+    ASSERT_FALSE(m_avatar->m_avatarPixmap.isNull());
+    EXPECT_EQ(m_avatar->m_avatarPixmap.cacheKey(), other.m_avatarPixmap.cacheKey());
+    const qint64 key = m_avatar->m_avatarPixmap.cacheKey();
+    m_avatar->grab();
+    EXPECT_EQ(m_avatar->m_avatarPixmap.cacheKey(), key);
+
+    // 禁用后使用灰度头像
+    m_avatar->setDisabled(true);
+    m_avatar->grab();
+    EXPECT_NE(m_avatar->m_avatarPixmap.cacheKey(), key);
+    EXPECT_FALSE(m_avatar->m_avatarPixmapEnabled);
+
+    // 头像变化后重新生成
+    other.setIcon(path);
+    EXPECT_TRUE(other.m_avatarPixmap.isNull());
+}
@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "userframelist.h"
+#include "sessionbasemodel.h"
+#include "userinfo.h"
+
+#include <QScrollArea>
+#include <QScrollBar>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+class UT_UserFrameList : public testing::Test
+{
+protected:
+    void SetUp() override;
+    void TearDown() override;
+
+    QWidget *m_parent;
+    SessionBaseModel *m_model;
+    UserFrameList *m_userFrameList;
+};
+
+void UT_UserFrameList::SetUp()
+{
+    m_parent = new QWidget;
+    m_parent->resize(1920, 1080);
+    m_model = new SessionBaseModel;
+    m_userFrameList = new UserFrameList(m_parent);
+}
+
+void UT_UserFrameList::TearDown()
+{
+    delete m_parent;
+    delete m_model;
+}
+
+TEST_F(UT_UserFrameList, VirtualizedTiles)
+{
+    const int count = 1000;
+    for (int i = count - 1; i >= 0; --i) {
+        std::shared_ptr<ADDomainUser> user(new ADDomainUser(static_cast<uint>(10000 + i)));
+        user->setName(QString("user%1").arg(i));
+        m_model->addUser(user);
+    }
+    m_model->updateCurrentUser(m_model->findUserByUid(10000));
+
+    m_userFrameList->setModel(m_model);
+    m_userFrameList->setFixedSize(QSize(1920, 1080));
+
+    ASSERT_EQ(m_userFrameList->m_users.size(), count);
+    EXPECT_EQ(m_userFrameList->m_tileRects.size(), count);
+    EXPECT_TRUE(std::is_sorted(m_userFrameList->m_users.cbegin(), m_userFrameList->m_users.cend(),
+                               [](const std::shared_ptr<User> &user1, const std::shared_ptr<User> &user2) {
+                                   return user1->uid() < user2->uid();
+                               }));
+
+    // 只为可见区域附近的用户创建控件
+    const int tileCount = m_userFrameList->m_tiles.size();
+    EXPECT_GT(tileCount, 0);
+    EXPECT_LT(tileCount, 30);
+
+    // 滚动到底部后复用之前的控件
+    QScrollBar *scrollBar = m_userFrameList->m_scrollArea->verticalScrollBar();
+    scrollBar->setValue(scrollBar->maximum());
+    EXPECT_LE(m_userFrameList->m_tiles.size() + m_userFrameList->m_idleWidgets.size(), tileCount * 2);
+
+    // 键盘切换用户
+    EXPECT_EQ(m_userFrameList->m_selectedUid, 10000u);
+    m_userFrameList->switchNextUser();
+    EXPECT_EQ(m_userFrameList->m_selectedUid, 10001u);
+    m_userFrameList->switchPreviousUser();
+    m_userFrameList->switchPreviousUser();
+    EXPECT_EQ(m_userFrameList->m_selectedUid, static_cast<uint>(10000 + count - 1));
+
+    // 删除用户
+    m_model->beginUserListUpdate();
+    m_model->removeUser(m_model->findUserByUid(10001));
+    m_model->commitUserListUpdate();
+    EXPECT_EQ(m_userFrameList->m_users.size(), count - 1);
+    EXPECT_EQ(m_userFrameList->indexOfUid(10001), -1);
+    EXPECT_EQ(m_userFrameList->indexOfUid(10002), 1);
+}
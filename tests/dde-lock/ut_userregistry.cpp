@@ -0,0 +1,127 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "user_registry.h"
+#include "userinfo.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+class UT_UserRegistry : public testing::Test
+{
+protected:
+    void SetUp() override;
+    void TearDown() override;
+
+    std::shared_ptr<ADDomainUser> createUser(uint uid, const QString &name);
+
+    UserRegistry *m_registry;
+};
+
+void UT_UserRegistry::SetUp()
+{
+    m_registry = new UserRegistry;
+}
+
+void UT_UserRegistry::TearDown()
+{
+    delete m_registry;
+}
+
+std::shared_ptr<ADDomainUser> UT_UserRegistry::createUser(uint uid, const QString &name)
+{
+    std::shared_ptr<ADDomainUser> user(new ADDomainUser(uid));
+    user->setName(name);
+    return user;
+}
+
+TEST_F(UT_UserRegistry, InsertAndRemove)
+{
+    auto alice = createUser(1000, "alice");
+    auto bob = createUser(1001, "bob");
+    m_registry->insert("/user/1000", alice);
+    m_registry->insert("/user/1001", bob);
+
+    EXPECT_EQ(m_registry->findByUid(1000), alice);
+    EXPECT_EQ(m_registry->findByName("bob"), bob);
+    EXPECT_EQ(m_registry->value("/user/1001"), bob);
+    EXPECT_TRUE(m_registry->contains(std::shared_ptr<User>(alice)));
+    EXPECT_EQ(m_registry->pathOf(bob), "/user/1001");
+    EXPECT_FALSE(m_registry->findByName(QString()));
+
+    m_registry->remove("/user/1000");
+    EXPECT_FALSE(m_registry->findByUid(1000));
+    EXPECT_FALSE(m_registry->findByName("alice"));
+    EXPECT_FALSE(m_registry->contains(std::shared_ptr<User>(alice)));
+    EXPECT_EQ(m_registry->size(), 1);
+}
+
+TEST_F(UT_UserRegistry, Rename)
+{
+    auto user = createUser(1000, "alice");
+    m_registry->insert("/user/1000", user);
+
+    user->setName("carol");
+    EXPECT_FALSE(m_registry->findByName("alice"));
+    EXPECT_EQ(m_registry->findByName("carol"), user);
+
+    // 删除后不再跟随用户名变化
+    m_registry->remove("/user/1000");
+    user->setName("dave");
+    EXPECT_FALSE(m_registry->findByName("dave"));
+}
+
+TEST_F(UT_UserRegistry, DuplicateKeepsFirstPath)
+{
+    auto first = createUser(1000, "alice");
+    auto second = createUser(1000, "alice");
+    m_registry->insert("/user/b", second);
+    m_registry->insert("/user/a", first);
+
+    // 和按路径顺序遍历查找的结果一致
+    EXPECT_EQ(m_registry->findByUid(1000), first);
+    EXPECT_EQ(m_registry->findByName("alice"), first);
+
+    m_registry->remove("/user/a");
+    EXPECT_EQ(m_registry->findByUid(1000), second);
+}
+
+TEST_F(UT_UserRegistry, LookupBenchmark)
+{
+    const int count = 10000;
+    QList<std::shared_ptr<User>> users;
+    for (int i = 0; i < count; ++i) {
+        auto user = createUser(static_cast<uint>(10000 + i), QString("user%1").arg(i));
+        users.append(user);
+        m_registry->insert(QString("/org/deepin/dde/Accounts1/User%1").arg(10000 + i), user);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < count; ++i) {
+        ASSERT_TRUE(m_registry->findByUid(static_cast<uint>(10000 + i)));
+        ASSERT_TRUE(m_registry->findByName(QString("user%1").arg(i)));
+    }
+    const qint64 indexedNs = timer.nsecsElapsed();
+
+    // 之前的实现：遍历所有用户
+    const QList<std::shared_ptr<User>> values = m_registry->values();
+    timer.restart();
+    for (int i = 0; i < count; i += 100) {
+        const uint uid = static_cast<uint>(10000 + i);
+        auto it = std::find_if(values.cbegin(), values.cend(), [uid](const std::shared_ptr<User> &user) {
+            return user->uid() == uid;
+        });
+        ASSERT_TRUE(it != values.cend());
+    }
+    const qint64 linearNs = timer.nsecsElapsed() * 100;
+
+    qInfo() << "Lookup" << count << "users by uid and name, indexed(us):" << indexedNs / 1000
+            << ", linear scan by uid only, extrapolated(us):" << linearNs / 1000;
+    EXPECT_LT(indexedNs, linearNs);
+}
@@ -0,0 +1,61 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "wallpaper_disk_cache.h"
+
+#include <QDir>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+
+#include <gtest/gtest.h>
+
+class UT_WallpaperDiskCache : public testing::Test
+{
+protected:
+    void SetUp() override;
+    void TearDown() override;
+
+    QTemporaryDir m_dir;
+    QString m_sourcePath;
+};
+
+void UT_WallpaperDiskCache::SetUp()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    m_sourcePath = m_dir.filePath("wallpaper.png");
+    QImage source(64, 48, QImage::Format_ARGB32);
+    source.fill(Qt::blue);
+    source.save(m_sourcePath);
+}
+
+void UT_WallpaperDiskCache::TearDown()
+{
+    QDir(WallpaperDiskCache::cacheDir()).removeRecursively();
+    QStandardPaths::setTestModeEnabled(false);
+}
+
+TEST_F(UT_WallpaperDiskCache, SaveAndLoad)
+{
+    const QSize size(32, 24);
+    EXPECT_TRUE(WallpaperDiskCache::load(m_sourcePath, size, 1.0).isNull());
+
+    QImage scaled(size, QImage::Format_ARGB32_Premultiplied);
+    scaled.fill(Qt::blue);
+    EXPECT_TRUE(WallpaperDiskCache::save(m_sourcePath, size, 1.0, scaled));
+
+    const QImage &loaded = WallpaperDiskCache::load(m_sourcePath, size, 1.0);
+    ASSERT_FALSE(loaded.isNull());
+    EXPECT_EQ(loaded.size(), size);
+    EXPECT_EQ(loaded.pixel(0, 0), scaled.pixel(0, 0));
+
+    // 尺寸和缩放比例不同的缓存互不影响
+    EXPECT_TRUE(WallpaperDiskCache::load(m_sourcePath, size, 2.0).isNull());
+    EXPECT_TRUE(WallpaperDiskCache::load(m_sourcePath, QSize(16, 12), 1.0).isNull());
+}
+
+TEST_F(UT_WallpaperDiskCache, RejectMismatchedSize)
+{
+    QImage scaled(QSize(10, 10), QImage::Format_ARGB32_Premultiplied);
+    EXPECT_FALSE(WallpaperDiskCache::save(m_sourcePath, QSize(20, 20), 1.0, scaled));
+}
@@ -4,6 +4,9 @@
 
 #include "xkbparser.h"
 
+#include <QFile>
+#include <QTemporaryDir>
+
 #include <gtest/gtest.h>
 
 class UT_XkbParser : public testing::Test
@@ -30,3 +33,57 @@ TEST_F(UT_XkbParser, basic)
     m_parser->lookUpKeyboardList(QStringList());
     m_parser->lookUpKeyboardKey(QString());
 }
+
+TEST_F(UT_XkbParser, IndexAndCache)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    const QString baseFile = dir.filePath("base.xml");
+    QFile file(baseFile);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+               "<xkbConfigRegistry version=\"1.1\">\n"
+               "  <modelList><model><configItem><name>pc105</name><description>Generic 105-key PC</description></configItem></model></modelList>\n"
+               "  <layoutList>\n"
+               "    <layout>\n"
+               "      <configItem><name>us</name><shortDescription>en</shortDescription><description>English (US)</description>\n"
+               "        <languageList><iso639Id>eng</iso639Id></languageList></configItem>\n"
+               "      <variantList>\n"
+               "        <variant><configItem><name>dvorak</name><description>English (Dvorak)</description></configItem></variant>\n"
+               "        <variant><configItem><name>intl</name><description>English (US, intl., with dead keys)</description></configItem></variant>\n"
+               "      </variantList>\n"
+               "    </layout>\n"
+               "    <layout>\n"
+               "      <configItem><name>cn</name><description>Chinese</description></configItem>\n"
+               "    </layout>\n"
+               "  </layoutList>\n"
+               "  <optionList><group><configItem><name>grp</name><description>Switching to another layout</description></configItem></group></optionList>\n"
+               "</xkbConfigRegistry>\n");
+    file.close();
+
+    XkbParser::Index index;
+    ASSERT_TRUE(XkbParser::parse(baseFile, index));
+    EXPECT_EQ(index.layouts.size(), 2);
+    EXPECT_EQ(index.layouts.value("us"), QString("English (US)"));
+    EXPECT_EQ(index.variants.size(), 2);
+    EXPECT_EQ(index.variants.value("us;dvorak"), QString("English (Dvorak)"));
+    EXPECT_EQ(index.keys.value("English (Dvorak)"), QString("us|dvorak"));
+    EXPECT_EQ(index.keys.value("Chinese"), QString("cn|"));
+    EXPECT_FALSE(index.keys.contains("Generic 105-key PC"));
+    EXPECT_FALSE(index.keys.contains("Switching to another layout"));
+
+    const QString cacheFile = dir.filePath("cache/base.cache");
+    ASSERT_TRUE(XkbParser::saveCache(cacheFile, baseFile, index));
+    XkbParser::Index cached;
+    ASSERT_TRUE(XkbParser::loadCache(cacheFile, baseFile, cached));
+    EXPECT_EQ(cached.layouts, index.layouts);
+    EXPECT_EQ(cached.variants, index.variants);
+    EXPECT_EQ(cached.keys, index.keys);
+
+    // base.xml 更新后缓存失效
+    ASSERT_TRUE(file.open(QIODevice::Append));
+    file.write("\n");
+    file.close();
+    EXPECT_FALSE(XkbParser::loadCache(cacheFile, baseFile, cached));
+}